@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+# Convert a binary event log written by M929 B1 into the same text format that M929 writes in text mode
+import sys
+import struct
+import argparse
+import datetime
+
+
+FILE_HEADER = b"RRFLOG1\n"
+RECORD_MARKER = 0xA5
+RECORD_HEADER = struct.Struct("<BBHII")     # marker, level, text length, seconds since 1970, milliseconds since power up
+
+levels = ["debug", "info", "warn", "off"]
+
+
+def format_time(seconds, millis):
+    if seconds == 0:
+        up = millis // 1000
+        return "power up + %02u:%02u:%02u" % (up // 3600, (up % 3600) // 60, up % 60)
+    return datetime.datetime.fromtimestamp(seconds, datetime.timezone.utc).strftime("%Y-%m-%d %H:%M:%S")
+
+
+def decode(data, out, show_millis):
+    if not data.startswith(FILE_HEADER):
+        print("Not a binary event log", file=sys.stderr)
+        return False
+    pos = len(FILE_HEADER)
+    skipped = 0
+    while pos + RECORD_HEADER.size <= len(data):
+        marker, level, length, seconds, millis = RECORD_HEADER.unpack_from(data, pos)
+        end = pos + RECORD_HEADER.size + length
+        if marker != RECORD_MARKER or level >= len(levels) or end > len(data):
+            # Corrupt or truncated record, so look for the next marker byte
+            pos += 1
+            skipped += 1
+            continue
+        if skipped != 0:
+            out.write("<%u bytes of corrupt data skipped>\n" % skipped)
+            skipped = 0
+        text = data[pos + RECORD_HEADER.size:end].decode("utf-8", errors="replace")
+        prefix = format_time(seconds, millis)
+        if show_millis:
+            prefix += " (%u.%03u)" % (millis // 1000, millis % 1000)
+        out.write("%s [%s] %s\n" % (prefix, levels[level], text))
+        pos = end
+    if pos != len(data):
+        out.write("<%u bytes of incomplete record at end of file>\n" % (len(data) - pos + skipped))
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a RepRapFirmware binary event log.")
+    parser.add_argument("input", metavar="INPUT", type=str, help="binary log file to decode")
+    parser.add_argument("-o", "--output", metavar="FILE", type=str, help="write the text log to FILE instead of standard output")
+    parser.add_argument("-m", "--millis", action="store_true", help="also show the time since power up of each record in milliseconds")
+    args = parser.parse_args()
+
+    with open(args.input, mode="rb") as f:
+        data = f.read()
+    if args.output:
+        with open(args.output, mode="w") as out:
+            ok = decode(data, out, args.millis)
+    else:
+        ok = decode(data, sys.stdout, args.millis)
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# Convert a binary heater telemetry file written by M306 B1 into the same CSV format that M306 writes in text mode
+import sys
+import struct
+import argparse
+
+
+FILE_HEADER = b"RRFHTL1\n"
+RECORD = struct.Struct("<IhhBBBx")      # millis since power up, temperature * 10, setpoint * 10, PWM * 255, feedforward * 255, heater mode
+CSV_HEADER = "time,temperature,setpoint,pwm,feedforward,mode\n"
+
+modes = ["fault", "offline", "off", "suspended", "heating", "cooling", "stable", "tuning0", "tuning1", "tuning2", "tuning3"]
+
+
+def decode(data, out, mode_names):
+    if not data.startswith(FILE_HEADER):
+        print("Not a binary heater telemetry file", file=sys.stderr)
+        return False
+    out.write(CSV_HEADER)
+    pos = len(FILE_HEADER)
+    while pos + RECORD.size <= len(data):
+        time, temperature, setpoint, pwm, feedforward, mode = RECORD.unpack_from(data, pos)
+        if mode_names:
+            mode = modes[mode] if mode < len(modes) else str(mode)
+        out.write("%u,%.1f,%.1f,%.3f,%.3f,%s\n" % (time, temperature / 10.0, setpoint / 10.0, pwm / 255.0, feedforward / 255.0, mode))
+        pos += RECORD.size
+    if pos != len(data):
+        print("%u bytes of incomplete record at end of file" % (len(data) - pos), file=sys.stderr)
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a RepRapFirmware binary heater telemetry file.")
+    parser.add_argument("input", metavar="INPUT", type=str, help="binary telemetry file to decode")
+    parser.add_argument("-o", "--output", metavar="FILE", type=str, help="write the CSV to FILE instead of standard output")
+    parser.add_argument("-n", "--mode-names", action="store_true", help="show heater modes as names instead of numbers")
+    args = parser.parse_args()
+
+    with open(args.input, mode="rb") as f:
+        data = f.read()
+    if args.output:
+        with open(args.output, mode="w") as out:
+            ok = decode(data, out, args.mode_names)
+    else:
+        ok = decode(data, sys.stdout, args.mode_names)
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -61,6 +61,11 @@ constexpr uint32_t FanCheckInterval = 500;				// Milliseconds
 constexpr uint32_t OpenLoadTimeout = 500;				// Milliseconds
 constexpr uint32_t MinimumWarningInterval = 4000;		// Milliseconds, must be at least as long as FanCheckInterval
 constexpr uint32_t LogFlushInterval = 15000;			// Milliseconds
+#if defined(__LPC17xx__)
+constexpr size_t LogRingBufferSize = 1024;				// Bytes of RAM used to queue binary log records
+#else
+constexpr size_t LogRingBufferSize = 4096;				// Bytes of RAM used to queue binary log records
+#endif
 constexpr uint32_t DriverCoolingTimeout = 4000;			// Milliseconds
 constexpr float DefaultMessageTimeout = 10.0;			// How long a message is displayed by default, in seconds
 constexpr uint16_t MinimumGpinReportInterval = 30;		// Minimum interval in milliseconds between input change reports sent over CAN bus
@@ -79,8 +84,19 @@ constexpr uint32_t AuxTimeout = 2000;					// timeout in ms for PanelDue replies
 #define PANEL_DUE_FIRMWARE_FILE "PanelDueFirmware.bin"
 
 // Heater values
-constexpr uint32_t HeatSampleIntervalMillis = 250;		// interval between taking temperature samples
+constexpr uint32_t HeatSampleIntervalMillis = 250;		// default interval between taking temperature samples
+constexpr uint32_t MinHeatSampleIntervalMillis = 20;	// shortest sample interval that a heater may be configured to use
+constexpr uint32_t MaxHeatSampleIntervalMillis = 2000;	// longest sample interval that a heater may be configured to use
+constexpr uint32_t HeatTaskTickMillis = 10;				// resolution of the heater task scheduler, sample intervals are rounded down to a multiple of this
 constexpr float HeatPwmAverageTime = 5.0;				// Seconds
+constexpr uint32_t ExtrusionFeedForwardWindowMillis = 500;	// time over which we average the future extrusion rate when calculating extrusion feedforward
+constexpr size_t MaxConcurrentTuningHeaters = 8;		// maximum number of heaters that may be auto tuned at the same time
+constexpr float HeaterPowerPriorityHolding = 1.0e6;		// power budget priority of heaters that are holding their temperature or being tuned
+#if defined(__LPC17xx__)
+constexpr size_t HeaterTelemetryRecords = 32;			// number of control loop samples that each local heater remembers, 12 bytes each
+#else
+constexpr size_t HeaterTelemetryRecords = 128;			// number of control loop samples that each local heater remembers, 12 bytes each
+#endif
 
 constexpr uint8_t SensorsTaskTotalDelay = 250;			// Interval between runs of sensors task
 
@@ -89,7 +105,8 @@ constexpr float TEMPERATURE_LOW_SO_DONT_CARE = 40.0;	// Celsius
 constexpr float HOT_ENOUGH_TO_EXTRUDE = 160.0;			// Celsius
 constexpr float HOT_ENOUGH_TO_RETRACT = 90.0;			// Celsius
 
-constexpr unsigned int MaxBadTemperatureCount = 2000/HeatSampleIntervalMillis;	// Number of bad temperature samples permitted before a heater fault is reported (2 seconds)
+constexpr uint32_t MaxBadTemperatureMillis = 2000;		// How long we permit bad temperature readings before a heater fault is reported
+constexpr unsigned int MaxBadTemperatureCount = MaxBadTemperatureMillis/HeatSampleIntervalMillis;	// Number of bad temperature samples permitted at the default sample interval
 constexpr float BadLowTemperature = -10.0;				// Celsius
 constexpr float DefaultHotEndTemperatureLimit = 285.0;	// Celsius - E3D say to tighten the hot end at 285C
 constexpr float DefaultBedTemperatureLimit = 125.0;		// Celsius
@@ -140,6 +157,7 @@ constexpr PwmFrequency ServoRefreshFrequency = 50;
 constexpr float DefaultMinFanPwm = 0.1;					// minimum fan PWM
 constexpr uint32_t DefaultFanBlipTime = 100;			// fan blip time in milliseconds
 #endif
+constexpr size_t MaxFanCurvePoints = 8;					// maximum number of temperature:PWM points in a fan curve
 
 // Conditional GCode support
 constexpr unsigned int MaxBlockIndent = 10;				// maximum indentation of GCode. Each level of indentation introduced a new block.
@@ -365,6 +383,7 @@ static_assert(MaxExpectedWebDirFilenameLength + strlen(WEB_DIR) + strlen(".gz")
 #define UPLOAD_EXTENSION ".part"					// Extension to a filename for a file being uploaded
 
 #define DEFAULT_LOG_FILE "eventlog.txt"
+#define DEFAULT_BINARY_LOG_FILE "eventlog.bin"
 
 #define EOF_STRING "<!-- **EoF** -->"
 
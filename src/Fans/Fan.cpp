@@ -6,6 +6,7 @@
  */
 
 #include "Fan.h"
+#include "FanCurve.h"
 #include <Platform/RepRap.h>
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 
@@ -50,11 +51,17 @@ Fan::Fan(unsigned int fanNum) noexcept
 	  val(0.0),
 	  minVal(DefaultMinFanPwm),
 	  maxVal(1.0),										// 100% maximum fan speed
-	  blipTime(DefaultFanBlipTime)
+	  blipTime(DefaultFanBlipTime),
+	  curve(nullptr)
 {
 	triggerTemperatures[0] = triggerTemperatures[1] = DefaultHotEndFanTemperature;
 }
 
+Fan::~Fan() noexcept
+{
+	delete curve;
+}
+
 // Set or report the parameters for this fan
 // If 'mcode' is an M-code used to set parameters for the f (which should only ever be 106)
 // then search for parameters used to configure the fan. If any are found, perform appropriate actions and return true.
@@ -81,6 +88,34 @@ bool Fan::Configure(unsigned int mcode, size_t fanNum, GCodeBuffer& gb, const St
 			seen = true;
 			size_t numTemps = 2;
 			gb.GetFloatArray(triggerTemperatures, numTemps, true);
+
+			// Trigger temperatures replace any fan curve
+			FanCurve *oldCurve = nullptr;
+			std::swap(oldCurve, curve);
+			delete oldCurve;
+		}
+		else if (gb.Seen('K'))									// Set a fan curve, with optional hysteresis and rate limit
+		{
+			seen = true;
+			float values[2 * MaxFanCurvePoints];
+			size_t numValues = ARRAY_SIZE(values);
+			gb.GetFloatArray(values, numValues, false);
+			float hysteresis = (curve != nullptr) ? curve->GetHysteresis() : ThermostatHysteresis;
+			float rateLimit = (curve != nullptr) ? curve->GetRateLimit() : 0.0;
+			bool dummy = false;
+			gb.TryGetFValue('Y', hysteresis, dummy);
+			gb.TryGetFValue('J', rateLimit, dummy);
+
+			FanCurve *newCurve = new FanCurve;
+			if (newCurve->Configure(values, numValues, hysteresis, rateLimit, reply) == GCodeResult::ok)
+			{
+				std::swap(newCurve, curve);
+			}
+			else
+			{
+				error = true;
+			}
+			delete newCurve;
 		}
 
 		if (gb.Seen('B'))										// Set blip time
@@ -168,7 +203,15 @@ bool Fan::Configure(unsigned int mcode, size_t fanNum, GCodeBuffer& gb, const St
 					  );
 			if (sensorsMonitored.IsNonEmpty())
 			{
-				reply.catf(", temperature: %.1f:%.1fC, sensors:", (double)triggerTemperatures[0], (double)triggerTemperatures[1]);
+				if (curve != nullptr)
+				{
+					curve->AppendDetails(reply);
+					reply.cat(", sensors:");
+				}
+				else
+				{
+					reply.catf(", temperature: %.1f:%.1fC, sensors:", (double)triggerTemperatures[0], (double)triggerTemperatures[1]);
+				}
 				sensorsMonitored.Iterate([&reply](unsigned int sensorNum, unsigned int) noexcept { reply.catf(" %u", sensorNum); });
 				reply.cat(", current speed: ");
 				const float lastVal = GetPwm();
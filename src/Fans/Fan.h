@@ -17,6 +17,7 @@
 #endif
 
 class GCodeBuffer;
+class FanCurve;
 
 class Fan INHERIT_OBJECT_MODEL
 {
@@ -24,7 +25,7 @@ public:
 	Fan(unsigned int fanNum) noexcept;
 	Fan(const Fan&) = delete;
 
-	virtual ~Fan() noexcept { }
+	virtual ~Fan() noexcept;
 	virtual bool Check(bool checkSensors) noexcept = 0;						// update the fan PWM returning true if it is a thermostatic fan that is on
 	virtual GCodeResult SetPwmFrequency(PwmFrequency freq, const StringRef& reply) noexcept = 0;
 	virtual bool IsEnabled() const noexcept = 0;
@@ -69,6 +70,7 @@ protected:
 	float triggerTemperatures[2];
 	uint32_t blipTime;										// how long we blip the fan for, in milliseconds
 	SensorsBitmap sensorsMonitored;
+	FanCurve *curve;										// the fan curve used instead of the trigger temperatures, or nullptr if there isn't one
 
 	String<MaxFanNameLength> name;
 };
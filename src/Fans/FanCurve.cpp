@@ -0,0 +1,120 @@
+/*
+ * FanCurve.cpp
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#include "FanCurve.h"
+
+FanCurve::FanCurve() noexcept
+	: numPoints(0), hysteresis(ThermostatHysteresis), rateLimit(0.0),
+	  effectiveTemperature(ABS_ZERO), currentPwm(-1.0), whenLastUpdated(0)
+{
+}
+
+// Set up the curve. The temperatures must increase and the PWMs must not decrease.
+// PWM values greater than 1 are taken to be in the range 0..255, as for M106 S.
+GCodeResult FanCurve::Configure(const float *values, size_t numValues, float hyst, float rate, const StringRef& reply) noexcept
+{
+	if (numValues < 4 || (numValues & 1) != 0)
+	{
+		reply.copy("fan curve must have at least two temperature:PWM pairs");
+		return GCodeResult::error;
+	}
+	if (hyst < 0.0 || rate < 0.0)
+	{
+		reply.copy("fan curve hysteresis and rate limit must not be negative");
+		return GCodeResult::error;
+	}
+
+	float newTemperatures[MaxFanCurvePoints];
+	float newPwms[MaxFanCurvePoints];
+	const size_t newNumPoints = numValues/2;
+	for (size_t i = 0; i < newNumPoints; ++i)
+	{
+		newTemperatures[i] = values[2 * i];
+		const float pwm = values[2 * i + 1];
+		newPwms[i] = constrain<float>((pwm > 1.0) ? pwm/255.0 : pwm, 0.0, 1.0);
+		if (i != 0 && (newTemperatures[i] <= newTemperatures[i - 1] || newPwms[i] < newPwms[i - 1]))
+		{
+			reply.copy("fan curve temperatures must increase and PWM values must not decrease");
+			return GCodeResult::error;
+		}
+	}
+
+	numPoints = newNumPoints;
+	memcpy(temperatures, newTemperatures, sizeof(temperatures));
+	memcpy(pwms, newPwms, sizeof(pwms));
+	hysteresis = hyst;
+	rateLimit = rate;
+	effectiveTemperature = ABS_ZERO;
+	currentPwm = -1.0;
+	return GCodeResult::ok;
+}
+
+// Get the PWM for a temperature by interpolating linearly between the points either side of it.
+// There are so few points that searching them is as quick as looking up a table, and it is exact however close together they are.
+float FanCurve::Lookup(float temperature) const noexcept
+{
+	if (temperature <= temperatures[0])
+	{
+		return pwms[0];
+	}
+	for (size_t i = 1; i < numPoints; ++i)
+	{
+		if (temperature < temperatures[i])
+		{
+			return pwms[i - 1] + (pwms[i] - pwms[i - 1]) * (temperature - temperatures[i - 1])/(temperatures[i] - temperatures[i - 1]);
+		}
+	}
+	return pwms[numPoints - 1];
+}
+
+float FanCurve::Update(float temperature, uint32_t now) noexcept
+{
+	if (temperature > effectiveTemperature)
+	{
+		effectiveTemperature = temperature;
+	}
+	else if (temperature + hysteresis < effectiveTemperature)
+	{
+		effectiveTemperature = temperature + hysteresis;
+	}
+
+	const float requiredPwm = Lookup(effectiveTemperature);
+	if (rateLimit > 0.0 && currentPwm >= 0.0)
+	{
+		const float maxChange = rateLimit * (float)(now - whenLastUpdated) * MillisToSeconds;
+		currentPwm = constrain<float>(requiredPwm, currentPwm - maxChange, currentPwm + maxChange);
+	}
+	else
+	{
+		currentPwm = requiredPwm;
+	}
+	whenLastUpdated = now;
+	return currentPwm;
+}
+
+// A sensor has failed or is out of range, so go to full speed immediately. The rate limit applies when the fan slows down again.
+float FanCurve::SetFull(uint32_t now) noexcept
+{
+	currentPwm = 1.0;
+	whenLastUpdated = now;
+	return currentPwm;
+}
+
+void FanCurve::AppendDetails(const StringRef& reply) const noexcept
+{
+	reply.cat(", curve:");
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		reply.catf(" %.1fC:%d%%", (double)temperatures[i], (int)lrintf(pwms[i] * 100.0));
+	}
+	reply.catf(", hysteresis %.1fC", (double)hysteresis);
+	if (rateLimit > 0.0)
+	{
+		reply.catf(", rate limit %d%%/sec", (int)lrintf(rateLimit * 100.0));
+	}
+}
+
+// End
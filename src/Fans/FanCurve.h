@@ -0,0 +1,45 @@
+/*
+ * FanCurve.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ *  Multi-point temperature to PWM curve for thermostatic fans, with hysteresis and a limit on how fast the PWM may change
+ */
+
+#ifndef SRC_FANS_FANCURVE_H_
+#define SRC_FANS_FANCURVE_H_
+
+#include <RepRapFirmware.h>
+
+// The curve is defined by up to MaxFanCurvePoints temperature:PWM points and is linear between them.
+// The fan speed follows temperature rises straight away, but it doesn't slow down until the temperature has fallen by more than the hysteresis.
+class FanCurve
+{
+public:
+	FanCurve() noexcept;
+
+	GCodeResult Configure(const float *values, size_t numValues, float hyst, float rate, const StringRef& reply) noexcept;	// values are temperature:PWM pairs
+	float Update(float temperature, uint32_t now) noexcept;			// Get the PWM to use for this temperature, allowing for the hysteresis and rate limit
+	float SetFull(uint32_t now) noexcept;							// Called when a sensor has failed, so the fan must run at full speed
+	void AppendDetails(const StringRef& reply) const noexcept;
+
+	float GetHysteresis() const noexcept { return hysteresis; }
+	float GetRateLimit() const noexcept { return rateLimit; }
+
+private:
+	float Lookup(float temperature) const noexcept;
+
+	// The curve as configured
+	size_t numPoints;
+	float temperatures[MaxFanCurvePoints];
+	float pwms[MaxFanCurvePoints];
+	float hysteresis;												// how far the temperature must fall before the fan slows down
+	float rateLimit;												// the most the PWM may change per second, or 0 if there is no limit
+
+	// State
+	float effectiveTemperature;										// the temperature after applying the hysteresis
+	float currentPwm;												// the PWM we returned last time, or -1 if we haven't returned one yet
+	uint32_t whenLastUpdated;
+};
+
+#endif /* SRC_FANS_FANCURVE_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "LocalFan.h"
+#include "FanCurve.h"
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Hardware/IoPorts.h>
 #include <Movement/StepTimer.h>
@@ -86,8 +87,10 @@ void LocalFan::InternalRefresh(bool checkSensors) noexcept
 	{
 		reqVal = 0.0;
 		const bool bangBangMode = (triggerTemperatures[1] <= triggerTemperatures[0]);
+		float hottest = ABS_ZERO;							// the highest temperature of the monitored sensors, used with a fan curve
+		bool sensorFault = false;
 		sensorsMonitored.Iterate
-		([&reqVal, bangBangMode, this
+		([&reqVal, &hottest, &sensorFault, bangBangMode, this
 #if HAS_SMART_DRIVERS
 		  , &driverChannelsMonitored
 #endif
@@ -99,7 +102,19 @@ void LocalFan::InternalRefresh(bool checkSensors) noexcept
 					//TODO we used to turn the fan on if the associated heater was being tuned
 					float ht;
 					const TemperatureError err = sensor->GetLatestTemperature(ht);
-					if (err != TemperatureError::success || ht < BadLowTemperature || ht >= triggerTemperatures[1])
+					if (curve != nullptr)
+					{
+						// The fan curve is applied to the hottest sensor once we have looked at them all
+						if (err != TemperatureError::success || ht < BadLowTemperature)
+						{
+							sensorFault = true;
+						}
+						else
+						{
+							hottest = max<float>(hottest, ht);
+						}
+					}
+					else if (err != TemperatureError::success || ht < BadLowTemperature || ht >= triggerTemperatures[1])
 					{
 						reqVal = max<float>(reqVal, (bangBangMode) ? max<float>(0.5, val) : 1.0);
 					}
@@ -123,6 +138,11 @@ void LocalFan::InternalRefresh(bool checkSensors) noexcept
 				}
 			}
 		);
+
+		if (curve != nullptr)
+		{
+			reqVal = (sensorFault) ? curve->SetFull(millis()) : curve->Update(hottest, millis());
+		}
 	}
 
 	if (reqVal > 0.0)
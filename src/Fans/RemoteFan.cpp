@@ -12,6 +12,7 @@
 #include "CanMessageBuffer.h"
 #include "CAN/CanInterface.h"
 #include "CAN/CanMessageGenericConstructor.h"
+#include "FanCurve.h"
 
 RemoteFan::RemoteFan(unsigned int fanNum, CanAddress boardNum) noexcept
 	: Fan(fanNum),
@@ -77,6 +78,16 @@ GCodeResult RemoteFan::ReportPortDetails(const StringRef& str) const noexcept
 
 bool RemoteFan::UpdateFanConfiguration(const StringRef& reply) noexcept
 {
+	if (curve != nullptr)
+	{
+		// The fan parameters message has no room for a curve
+		reply.copy("fan curves are not supported on expansion boards");
+		FanCurve *oldCurve = nullptr;
+		std::swap(oldCurve, curve);
+		delete oldCurve;
+		return false;
+	}
+
 	CanMessageBuffer *buf = CanMessageBuffer::Allocate();
 	if (buf == nullptr)
 	{
@@ -2630,6 +2630,10 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 			result = GCodeResult::error;
 			break;
 
+		case 306: // Report or save recent heater control loop samples
+			result = reprap.GetHeat().ExportHeaterTelemetry(gb, reply, outBuf);
+			break;
+
 		case 307: // Set heater process model parameters
 			result = reprap.GetHeat().SetOrReportHeaterModel(gb, reply);
 			break;
@@ -3449,7 +3453,12 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 					seen = true;
 					heaterFaultTimeout = gb.GetUIValue() * (60 * 1000);
 				}
-				if (gb.Seen('H'))
+				if (gb.Seen('W'))
+				{
+					seen = true;
+					result = reprap.GetHeat().ConfigurePowerBudget(gb, reply);
+				}
+				if (result == GCodeResult::ok && gb.Seen('H'))		// if the W parameter was bad then report that error
 				{
 					seen = true;
 					result = reprap.GetHeat().ConfigureHeaterMonitoring(gb.GetUIValue(), gb, reply);
@@ -3457,6 +3466,7 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 				if (!seen)
 				{
 					reply.printf("Print will be terminated if a heater fault is not reset within %" PRIu32 " minutes", heaterFaultTimeout/(60 * 1000));
+					reprap.GetHeat().ReportPowerBudget(reply);
 				}
 			}
 			break;
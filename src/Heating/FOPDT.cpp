@@ -31,10 +31,12 @@ constexpr ObjectModelTableEntry FopDt::objectModelTable[] =
 	// 0. FopDt members
 	{ "deadTime",			OBJECT_MODEL_FUNC(self->deadTime, 1),												ObjectModelEntryFlags::none },
 	{ "enabled",			OBJECT_MODEL_FUNC(self->enabled),													ObjectModelEntryFlags::none },
+	{ "extrusionCoefficient", OBJECT_MODEL_FUNC(self->extrusionCoefficient, 4),								ObjectModelEntryFlags::none },
 	{ "gain",				OBJECT_MODEL_FUNC(self->GetGainFanOff(), 1),										ObjectModelEntryFlags::none },	// legacy, to be removed
 	{ "heatingRate",		OBJECT_MODEL_FUNC(self->heatingRate, 3),											ObjectModelEntryFlags::none },
 	{ "inverted",			OBJECT_MODEL_FUNC(self->inverted),													ObjectModelEntryFlags::none },
 	{ "maxPwm",				OBJECT_MODEL_FUNC(self->maxPwm, 2),													ObjectModelEntryFlags::none },
+	{ "mpc",				OBJECT_MODEL_FUNC(self->useMpc),													ObjectModelEntryFlags::none },
 	{ "pid",				OBJECT_MODEL_FUNC(self, 1),															ObjectModelEntryFlags::none },
 	{ "standardVoltage",	OBJECT_MODEL_FUNC(self->standardVoltage, 1),										ObjectModelEntryFlags::none },
 	{ "timeConstant",		OBJECT_MODEL_FUNC(self->GetTimeConstantFanOff(), 1),								ObjectModelEntryFlags::none },
@@ -48,7 +50,7 @@ constexpr ObjectModelTableEntry FopDt::objectModelTable[] =
 	{ "used",				OBJECT_MODEL_FUNC(self->usePid),													ObjectModelEntryFlags::none },
 };
 
-constexpr uint8_t FopDt::objectModelTableDescriptor[] = { 2, 10, 5 };
+constexpr uint8_t FopDt::objectModelTableDescriptor[] = { 2, 12, 5 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(FopDt)
 
@@ -104,7 +106,9 @@ void FopDt::SetDefaultToolParameters() noexcept
 	coolingRateChangeFanOn = 0.0;
 	maxPwm = 1.0;
 	standardVoltage = 0.0;
+	extrusionCoefficient = 0.0;
 	usePid = true;
+	useMpc = false;
 	inverted = false;
 	enabled = true;
 	CalcPidConstants();
@@ -119,7 +123,9 @@ void FopDt::SetDefaultBedOrChamberParameters() noexcept
 	coolingRateChangeFanOn = 0.0;
 	maxPwm = 1.0;
 	standardVoltage = 0.0;
+	extrusionCoefficient = 0.0;
 	usePid = false;
+	useMpc = false;
 	inverted = false;
 	enabled = true;
 	CalcPidConstants();
@@ -160,9 +166,14 @@ bool FopDt::WriteParameters(FileStore *f, size_t heater) const noexcept
 							(double)deadTime,
 							(double)maxPwm,
 							(double)standardVoltage,
-							(usePid) ? 0 : 1,
+							(!usePid) ? 1 : (useMpc) ? 2 : 0,
 							(inverted) ? 1 : 0);
 	bool ok = f->Write(scratchString.c_str());
+	if (ok && extrusionCoefficient > 0.0)
+	{
+		scratchString.printf("M307 H%u E%.4f\n", heater, (double)extrusionCoefficient);
+		ok = f->Write(scratchString.c_str());
+	}
 	if (ok && pidParametersOverridden)
 	{
 		const M301PidParameters pp = GetM301PidParameters(false);
@@ -56,8 +56,12 @@ public:
 	float GetMaxPwm() const noexcept { return maxPwm; }
 	float GetVoltage() const noexcept { return standardVoltage; }
 	bool UsePid() const noexcept { return usePid; }
+	bool UseMpc() const noexcept { return usePid && useMpc && !inverted; }
+	void SetUseMpc(bool b) noexcept { useMpc = b; }
 	bool IsInverted() const noexcept { return inverted; }
 	bool IsEnabled() const noexcept { return enabled; }
+	float GetExtrusionCoefficient() const noexcept { return extrusionCoefficient; }
+	void SetExtrusionCoefficient(float f) noexcept { extrusionCoefficient = f; }
 
 	// Derived parameters
 	float GetGainFanOff() const noexcept { return heatingRate/coolingRateFanOff; }
@@ -92,8 +96,10 @@ private:
 	float deadTime;
 	float maxPwm;
 	float standardVoltage;					// power voltage reading at which tuning was done, or 0 if unknown
+	float extrusionCoefficient;				// additional PWM needed per mm^3/sec of extrusion, or 0 if extrusion feedforward is not used
 	bool enabled;
 	bool usePid;
+	bool useMpc;							// true to use model predictive control instead of PID
 	bool inverted;
 	bool pidParametersOverridden;
 
@@ -23,7 +23,9 @@ Licence: GPL
 #include "HeaterMonitor.h"
 #include <Platform/Platform.h>
 #include <Platform/RepRap.h>
+#include <Platform/OutputMemory.h>
 #include "Sensors/TemperatureSensor.h"
+#include "Sensors/SpiTemperatureSensor.h"
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Tools/Tool.h>
 #include <Platform/TaskPriorities.h>
@@ -74,6 +76,14 @@ extern "C" [[noreturn]] void SensorsTaskStart(void * pvParameters) noexcept
 	reprap.GetHeat().SensorsTask();
 }
 
+static constexpr uint16_t SpiSensorsTaskStackWords = 150;	// task stack size in dwords
+static Task<SpiSensorsTaskStackWords> *spiSensorsTask = nullptr;
+
+extern "C" [[noreturn]] void SpiSensorsTaskStart(void * pvParameters) noexcept
+{
+	reprap.GetHeat().SpiSensorsTask();
+}
+
 #if SUPPORT_OBJECT_MODEL
 // Object model table and functions
 // Note: if using GCC version 7.3.1 20180622 and lambda functions are used in this table, you must compile this file with option -std=gnu++17.
@@ -124,7 +134,7 @@ ReadWriteLock Heat::heatersLock;
 ReadWriteLock Heat::sensorsLock;
 
 Heat::Heat() noexcept
-	: sensorCount(0), sensorsRoot(nullptr), coldExtrude(false), heaterBeingTuned(-1), lastHeaterTuned(-1)
+	: sensorCount(0), sensorsRoot(nullptr), coldExtrude(false), lastHeaterTuned(-1), heaterPowerBudget(0.0), scheduleChanged(true)
 {
 	for (int8_t& h : bedHeaters)
 	{
@@ -141,6 +151,14 @@ Heat::Heat() noexcept
 		h = nullptr;
 	}
 
+	for (size_t h : ARRAY_INDICES(heaterPowerDemands))
+	{
+		heaterPowerDemands[h] = heaterPowerPriorities[h] = heaterPowerGranted[h] = 0.0;
+#if SUPPORT_HEATER_SIMULATION
+		simulatedHeaterPwms[h] = simulatedHeaterTargets[h] = 0.0;
+#endif
+	}
+
 	// Then set up the real heaters and the corresponding PIDs
 	for (const Tool*& t : lastStandbyTools)
 	{
@@ -168,6 +186,60 @@ GCodeResult Heat::SetOrReportHeaterModel(GCodeBuffer& gb, const StringRef& reply
 	return GCodeResult::error;
 }
 
+// Process M306. Report the most recent control loop samples of a heater in CSV format, or save them to a file in CSV or binary format.
+GCodeResult Heat::ExportHeaterTelemetry(GCodeBuffer& gb, const StringRef& reply, OutputBuffer*& outBuf) THROWS(GCodeException)
+{
+	const unsigned int heater = gb.GetLimitedUIValue('H', MaxHeaters);
+	const size_t maxRecords = (gb.Seen('S')) ? gb.GetUIValue() : HeaterTelemetryRecords;
+	const auto h = FindHeater(heater);
+	if (h.IsNull())
+	{
+		reply.printf("Heater %u not found", heater);
+		return GCodeResult::error;
+	}
+
+	const HeaterTelemetry * const telemetry = h->GetTelemetry();
+	if (telemetry == nullptr)
+	{
+		reply.printf("Heater %u does not record telemetry", heater);
+		return GCodeResult::error;
+	}
+
+	if (gb.Seen('P'))
+	{
+#if HAS_MASS_STORAGE
+		String<MaxFilenameLength> filename;
+		gb.GetQuotedString(filename.GetRef());
+		const bool binary = gb.Seen('B') && gb.GetUIValue() != 0;
+		FileStore * const f = reprap.GetPlatform().OpenSysFile(filename.c_str(), OpenMode::write);
+		if (f == nullptr)
+		{
+			reply.printf("Failed to create file %s", filename.c_str());
+			return GCodeResult::error;
+		}
+		const bool ok = telemetry->WriteToFile(f, binary, maxRecords);
+		f->Close();
+		if (!ok)
+		{
+			reply.printf("Failed to write heater telemetry to file %s", filename.c_str());
+			return GCodeResult::error;
+		}
+		return GCodeResult::ok;
+#else
+		reply.copy("Saving heater telemetry to a file is not supported");
+		return GCodeResult::error;
+#endif
+	}
+
+	if (!OutputBuffer::Allocate(outBuf))
+	{
+		reply.copy("No output buffer");
+		return GCodeResult::error;
+	}
+	telemetry->AppendCsv(outBuf, maxRecords);
+	return GCodeResult::ok;
+}
+
 // Process M301 or M304. 'heater' is the default heater number to use.
 GCodeResult Heat::SetPidParameters(unsigned int heater, GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
@@ -295,75 +367,176 @@ void Heat::Exit() noexcept
 [[noreturn]] void Heat::HeaterTask() noexcept
 {
 	uint32_t lastWakeTime = xTaskGetTickCount();
+#if SUPPORT_CAN_EXPANSION
+	uint32_t lastBroadcastTime = lastWakeTime;
+#endif
+	HeatersBitmap deferredHeaters;								// heaters that were due last tick but whose sensor reading was still pending
 	for (;;)
 	{
-		// Walk the sensor list and poll all sensors. The list is in increasing sensor number order.
+		if (scheduleChanged)
 		{
-#if SUPPORT_CAN_EXPANSION
-			// Set up to broadcast our sensor temperatures
-			CanMessageBuffer buf(nullptr);
-			CanMessageSensorTemperatures * const msg = buf.SetupBroadcastMessage<CanMessageSensorTemperatures>(CanInterface::GetCanAddress());
-			msg->whichSensors = 0;
-			unsigned int sensorsFound = 0;
-#endif
+			RebuildSchedule();
+		}
+
+		HeatersBitmap dueHeaters;
+		SensorsBitmap dueSensors;
+		timerWheel.Tick(dueHeaters, dueSensors);
+
+		// Poll the sensors that are due before spinning the heaters that use them
+		if (dueSensors.IsNonEmpty())
+		{
+			ReadLocker lock(sensorsLock);
+			for (TemperatureSensor *currentSensor = sensorsRoot; currentSensor != nullptr; currentSensor = currentSensor->GetNext())
 			{
-				ReadLocker lock(sensorsLock);
-				TemperatureSensor *currentSensor = sensorsRoot;
-				while (currentSensor != nullptr)
+				if (dueSensors.IsBitSet(currentSensor->GetSensorNumber()))
 				{
 					currentSensor->Poll();
-#if SUPPORT_CAN_EXPANSION
-					if (currentSensor->GetBoardAddress() == CanInterface::GetCanAddress())
-					{
-						msg->whichSensors |= (uint64_t)1u << currentSensor->GetSensorNumber();
-						float temperature;
-						msg->temperatureReports[sensorsFound].errorCode = (uint8_t)currentSensor->GetLatestTemperature(temperature);
-						msg->temperatureReports[sensorsFound].SetTemperature(temperature);
-						++sensorsFound;
-					}
-#endif
-					currentSensor = currentSensor->GetNext();
 				}
 			}
+		}
+
+		// Start the SPI sensors task reading any SPI sensors that were due. It runs when this task sleeps.
+		if (spiSensorsTask != nullptr && SpiTemperatureSensor::AnyReadsQueued())
+		{
+			spiSensorsTask->Give();
+		}
+
 #if SUPPORT_CAN_EXPANSION
-			if (sensorsFound != 0)							// don't send an empty report
+		if (xTaskGetTickCount() - lastBroadcastTime >= HeatSampleIntervalMillis)
+		{
+			lastBroadcastTime += HeatSampleIntervalMillis;
+			BroadcastSensorTemperatures();
+		}
+#endif
+
+		// Spin the heaters that are due. If a heater's sensor has a reading pending then defer it to the next tick so that it uses the new reading,
+		// but never defer a heater more than once so that a slow SPI bus can't stop it being spun.
+		const HeatersBitmap heatersToSpin = dueHeaters | deferredHeaters;
+		const HeatersBitmap wasDeferred = deferredHeaters;
+		deferredHeaters.Clear();
+		if (heatersToSpin.IsNonEmpty())
+		{
+			ReadLocker lock(heatersLock);
+			heatersToSpin.Iterate([this, &deferredHeaters, wasDeferred](unsigned int heater, unsigned int) noexcept
+								{
+									Heater * const h = heaters[heater];
+									if (h != nullptr)
+									{
+										if (!wasDeferred.IsBitSet(heater) && IsSensorReadPending(h->GetSensorNumber()))
+										{
+											deferredHeaters.SetBit(heater);
+										}
+										else
+										{
+											h->Spin();
+										}
+									}
+								});
+		}
+
+		// See if we have finished tuning any heaters
+		if (!heatersBeingTuned.IsEmpty())
+		{
+			HeatersBitmap finished;
+			heatersBeingTuned.Iterate([this, &finished](unsigned int heater, unsigned int)
+										{
+											const auto h = FindHeater(heater);
+											if (h.IsNull() || h->GetStatus() != HeaterStatus::tuning)
+											{
+												finished.SetBit(heater);
+											}
+										});
+			if (!finished.IsEmpty())
 			{
-				buf.dataLength = msg->GetActualDataLength(sensorsFound);
-				CanInterface::SendBroadcastNoFree(&buf);
+				TaskCriticalSectionLocker lock;
+				heatersBeingTuned &= ~finished;
+				lastHeaterTuned = (int8_t)finished.LowestSetBit();
 			}
-#endif
 		}
 
-		// Spin the heaters
+		reprap.KickHeatTaskWatchdog();
+
+		// Delay until it is time again
+		vTaskDelayUntil(&lastWakeTime, HeatTaskTickMillis);
+	}
+}
+
+// Put every heater and sensor on the timer wheel. Each sensor is polled as often as the most frequently sampled heater that uses it needs.
+// Called by the heater task.
+void Heat::RebuildSchedule() noexcept
+{
+	scheduleChanged = false;
+	timerWheel.Clear();
+
+	uint16_t sensorIntervals[MaxSensors];
+	for (uint16_t& interval : sensorIntervals)
+	{
+		interval = HeatSampleIntervalMillis;
+	}
+
+	{
+		ReadLocker lock(heatersLock);
+		for (size_t heater : ARRAY_INDICES(heaters))
 		{
-			ReadLocker lock(heatersLock);
-			for (Heater *h : heaters)
+			const Heater * const h = heaters[heater];
+			if (h != nullptr)
 			{
-				if (h != nullptr)
+				timerWheel.ScheduleHeater(heater, h->GetSampleIntervalMillis());
+				const int sensorNumber = h->GetSensorNumber();
+				if (sensorNumber >= 0 && sensorNumber < (int)MaxSensors)
 				{
-					h->Spin();
+					sensorIntervals[sensorNumber] = min<uint16_t>(sensorIntervals[sensorNumber], h->GetSampleIntervalMillis());
 				}
 			}
 		}
+	}
+
+	ReadLocker lock(sensorsLock);
+	for (const TemperatureSensor *sensor = sensorsRoot; sensor != nullptr; sensor = sensor->GetNext())
+	{
+		timerWheel.ScheduleSensor(sensor->GetSensorNumber(), max<uint32_t>(sensorIntervals[sensor->GetSensorNumber()], sensor->GetMinimumPollInterval()));
+	}
+}
 
-		// See if we have finished tuning a PID
-		if (heaterBeingTuned != -1)
+// Return true if the specified sensor is waiting for a reading to be taken
+bool Heat::IsSensorReadPending(int sensorNumber) const noexcept
+{
+	const auto sensor = FindSensor(sensorNumber);
+	return sensor.IsNotNull() && sensor->IsReadPending();
+}
+
+#if SUPPORT_CAN_EXPANSION
+
+// Broadcast the temperatures of our own sensors
+void Heat::BroadcastSensorTemperatures() noexcept
+{
+	CanMessageBuffer buf(nullptr);
+	CanMessageSensorTemperatures * const msg = buf.SetupBroadcastMessage<CanMessageSensorTemperatures>(CanInterface::GetCanAddress());
+	msg->whichSensors = 0;
+	unsigned int sensorsFound = 0;
+	{
+		ReadLocker lock(sensorsLock);
+		for (TemperatureSensor *currentSensor = sensorsRoot; currentSensor != nullptr; currentSensor = currentSensor->GetNext())
 		{
-			const auto h = FindHeater(heaterBeingTuned);
-			if (h.IsNull() || h->GetStatus() != HeaterStatus::tuning)
+			if (currentSensor->GetBoardAddress() == CanInterface::GetCanAddress())
 			{
-				lastHeaterTuned = heaterBeingTuned;
-				heaterBeingTuned = -1;
+				msg->whichSensors |= (uint64_t)1u << currentSensor->GetSensorNumber();
+				float temperature;
+				msg->temperatureReports[sensorsFound].errorCode = (uint8_t)currentSensor->GetLatestTemperature(temperature);
+				msg->temperatureReports[sensorsFound].SetTemperature(temperature);
+				++sensorsFound;
 			}
 		}
-
-		reprap.KickHeatTaskWatchdog();
-
-		// Delay until it is time again
-		vTaskDelayUntil(&lastWakeTime, HeatSampleIntervalMillis);
+	}
+	if (sensorsFound != 0)							// don't send an empty report
+	{
+		buf.dataLength = msg->GetActualDataLength(sensorsFound);
+		CanInterface::SendBroadcastNoFree(&buf);
 	}
 }
 
+#endif
+
 
 /* static */ void Heat::EnsureSensorsTask() noexcept
 {
@@ -425,6 +598,39 @@ void Heat::Exit() noexcept
 	}
 }
 
+/* static */ void Heat::EnsureSpiSensorsTask() noexcept
+{
+	TaskCriticalSectionLocker lock; // make sure we don't create the task more than once
+
+	if (spiSensorsTask == nullptr)
+	{
+		spiSensorsTask = new Task<SpiSensorsTaskStackWords>;
+		spiSensorsTask->Create(SpiSensorsTaskStart, "SPISENS", nullptr, TaskPriority::HeatPriority);
+	}
+}
+
+// Code executed by the SPI sensors task. It takes the readings that the heater task has requested from SPI temperature sensors,
+// so that the heater task never has to wait for the shared SPI bus or for the transfers to complete.
+[[noreturn]] void Heat::SpiSensorsTask() noexcept
+{
+	for (;;)
+	{
+		TaskBase::Take();
+
+		// Hold the sensors lock while taking readings so that a sensor can't be deleted while we are reading it
+		ReadLocker lock(sensorsLock);
+		for (;;)
+		{
+			SpiTemperatureSensor * const sensor = SpiTemperatureSensor::DequeueRead();
+			if (sensor == nullptr)
+			{
+				break;
+			}
+			sensor->DoQueuedRead();
+		}
+	}
+}
+
 void Heat::Diagnostics(MessageType mtype) noexcept
 {
 	Platform& platform = reprap.GetPlatform();
@@ -457,6 +663,12 @@ void Heat::Diagnostics(MessageType mtype) noexcept
 			platform.MessageF(mtype, "Heater %u is on, I-accum = %.1f\n", heater, (double)acc);
 		}
 	}
+
+	ReadLocker lock(sensorsLock);
+	for (TemperatureSensor *sensor = sensorsRoot; sensor != nullptr; sensor = sensor->GetNext())
+	{
+		sensor->Diagnostics(mtype);
+	}
 }
 
 // Configure a heater. Invoked by M950.
@@ -479,6 +691,8 @@ GCodeResult Heat::ConfigureHeater(GCodeBuffer& gb, const StringRef& reply) THROW
 			Heater *oldHeater = nullptr;
 			std::swap(oldHeater, heaters[heater]);
 			delete oldHeater;
+			ReleaseHeaterPower(heater);
+			scheduleChanged = true;
 			reprap.HeatUpdated();
 			return GCodeResult::ok;
 		}
@@ -491,6 +705,7 @@ GCodeResult Heat::ConfigureHeater(GCodeBuffer& gb, const StringRef& reply) THROW
 		Heater *oldHeater = nullptr;
 		std::swap(oldHeater, heaters[heater]);
 		delete oldHeater;
+		ReleaseHeaterPower(heater);
 
 		const PwmFrequency freq = (gb.Seen('Q')) ? min<PwmFrequency>(gb.GetPwmFrequency(), MaxHeaterPwmFrequency) : DefaultHeaterPwmFreq;
 
@@ -508,6 +723,7 @@ GCodeResult Heat::ConfigureHeater(GCodeBuffer& gb, const StringRef& reply) THROW
 		{
 			delete newHeater;
 		}
+		scheduleChanged = true;
 		reprap.HeatUpdated();
 		return rslt;
 	}
@@ -807,6 +1023,18 @@ bool Heat::WriteModelParameters(FileStore *f) const noexcept
 			{
 				ok = model.WriteParameters(f, h);
 			}
+			if (ok && heaters[h]->GetSampleIntervalMillis() != HeatSampleIntervalMillis)
+			{
+				String<StringLength50> scratchString;
+				scratchString.printf("M307 H%u Q%" PRIu32 "\n", h, heaters[h]->GetSampleIntervalMillis());
+				ok = f->Write(scratchString.c_str());
+			}
+			if (ok && heaters[h]->GetRatedPower() > 0.0)
+			{
+				String<StringLength50> scratchString;
+				scratchString.printf("M307 H%u W%.1f\n", h, (double)heaters[h]->GetRatedPower());
+				ok = f->Write(scratchString.c_str());
+			}
 		}
 	}
 	return ok;
@@ -814,6 +1042,70 @@ bool Heat::WriteModelParameters(FileStore *f) const noexcept
 
 #endif
 
+// Process M570 W
+GCodeResult Heat::ConfigurePowerBudget(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
+{
+	const float budget = gb.GetFValue();
+	if (budget < 0.0)
+	{
+		reply.copy("heater power budget must not be negative");
+		return GCodeResult::error;
+	}
+	heaterPowerBudget = budget;
+	return GCodeResult::ok;
+}
+
+void Heat::ReportPowerBudget(const StringRef& reply) const noexcept
+{
+	if (heaterPowerBudget <= 0.0)
+	{
+		reply.cat("\nHeater power is not limited");
+	}
+	else
+	{
+		float totalGranted = 0.0;
+		for (float granted : heaterPowerGranted)
+		{
+			totalGranted += granted;
+		}
+		reply.catf("\nHeater power is limited to %.0fW, heaters with known power are using %.0fW", (double)heaterPowerBudget, (double)totalGranted);
+	}
+}
+
+// Share out the heater power budget. Each heater calls this each time it calculates its PWM, passing the power it wants and its priority.
+// It is allowed whatever is left of the budget after every heater with a higher priority has been given what it most recently asked for,
+// so heaters that are holding temperature keep their power and the heater that has furthest to go gets the rest first.
+// Each heater uses the latest demands of the others, so the total can exceed the budget briefly when demands change quickly.
+float Heat::AllocateHeaterPower(unsigned int heater, float demandWatts, float priority) noexcept
+{
+	TaskCriticalSectionLocker lock;				// heaters may be switched off by other tasks while we do this
+	heaterPowerDemands[heater] = demandWatts;
+	heaterPowerPriorities[heater] = priority;
+
+	float granted = demandWatts;
+	if (heaterPowerBudget > 0.0)
+	{
+		float higherPriorityWatts = 0.0;
+		for (size_t i : ARRAY_INDICES(heaterPowerDemands))
+		{
+			if (i != heater && (heaterPowerPriorities[i] > priority || (heaterPowerPriorities[i] == priority && i < heater)))
+			{
+				higherPriorityWatts += heaterPowerDemands[i];
+			}
+		}
+		granted = constrain<float>(heaterPowerBudget - higherPriorityWatts, 0.0, demandWatts);
+	}
+	heaterPowerGranted[heater] = granted;
+	return granted;
+}
+
+// Stop counting a heater's power against the budget, so that its last demand isn't held back from the other heaters when it is switched off or faulted
+void Heat::ReleaseHeaterPower(unsigned int heater) noexcept
+{
+	TaskCriticalSectionLocker lock;
+	heaterPowerDemands[heater] = heaterPowerGranted[heater] = 0.0;
+}
+
 // Process M570
 GCodeResult Heat::ConfigureHeaterMonitoring(size_t heater, GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
@@ -881,32 +1173,50 @@ GCodeResult Heat::TuneHeater(GCodeBuffer& gb, const StringRef& reply) THROWS(GCo
 
 	if (seenHeater || seenTool)
 	{
-		if (heaterBeingTuned != -1)
+		const auto h = FindHeater(heaterNumber);
+		if (h.IsNull())
 		{
-			// Trying to start a new auto tune, but we are already tuning a heater
-			reply.printf("Error: cannot start a new auto tune because heater %d is being tuned", heaterBeingTuned);
+			reply.printf("Heater %u not found", heaterNumber);
 			return GCodeResult::error;
 		}
 
-		const auto h = FindHeater(heaterNumber);
-		if (h.IsNull())
+		if (!CanTuneAlongsideOthers(heaterNumber, fans, reply))
 		{
-			reply.printf("Heater %u not found", heaterNumber);
 			return GCodeResult::error;
 		}
 
 		const GCodeResult rslt = h->StartAutoTune(gb, reply, fans);
 		if (rslt <= GCodeResult::warning)
 		{
-			heaterBeingTuned = (int8_t)heaterNumber;
+			TaskCriticalSectionLocker lock;
+			heatersBeingTuned.SetBit(heaterNumber);
 		}
 		return rslt;
 	}
 
-	// If we get here then neither T nor H was given, so report the auto tune status
-	const int whichPid = (heaterBeingTuned == -1) ? lastHeaterTuned : heaterBeingTuned;
-	const auto h = FindHeater(whichPid);
+	// If we get here then neither T nor H was given, so report the auto tune status of every heater being tuned, or else the last one tuned
+	if (!heatersBeingTuned.IsEmpty())
+	{
+		bool first = true;
+		heatersBeingTuned.Iterate([this, &reply, &first](unsigned int heater, unsigned int)
+									{
+										const auto h = FindHeater(heater);
+										if (h.IsNotNull())
+										{
+											String<StringLength100> status;
+											h->GetAutoTuneStatus(status.GetRef());
+											if (!first)
+											{
+												reply.cat('\n');
+											}
+											reply.cat(status.c_str());
+											first = false;
+										}
+									});
+		return GCodeResult::ok;
+	}
 
+	const auto h = FindHeater(lastHeaterTuned);
 	if (h.IsNotNull())
 	{
 		h->GetAutoTuneStatus(reply);
@@ -918,6 +1228,66 @@ GCodeResult Heat::TuneHeater(GCodeBuffer& gb, const StringRef& reply) THROWS(GCo
 	return GCodeResult::ok;
 }
 
+// Check whether a heater may be tuned while the heaters already being tuned continue. Heaters tuned together must not share fans,
+// because each tuning run switches its fans on and off. Only one bed or chamber heater may be tuned at a time, because they share a supply
+// that may not be able to power several of them at full PWM. Remote heaters on the same board are not tuned together because the
+// expansion board firmware tunes one heater at a time.
+bool Heat::CanTuneAlongsideOthers(unsigned int heaterNumber, FansBitmap fans, const StringRef& reply) const noexcept
+{
+	if (heatersBeingTuned.IsBitSet(heaterNumber))
+	{
+		reply.printf("heater %u is already being tuned", heaterNumber);
+		return false;
+	}
+
+	if (heatersBeingTuned.CountSetBits() >= MaxConcurrentTuningHeaters)
+	{
+		reply.printf("cannot tune more than %u heaters at the same time", (unsigned int)MaxConcurrentTuningHeaters);
+		return false;
+	}
+
+#if SUPPORT_CAN_EXPANSION
+	CanAddress boardAddress;
+	{
+		const auto h = FindHeater(heaterNumber);
+		boardAddress = h->GetBoardAddress();
+	}
+#endif
+
+	const bool isBedOrChamber = IsBedOrChamberHeater(heaterNumber);
+	bool ok = true;
+	heatersBeingTuned.Iterate([&](unsigned int other, unsigned int)
+								{
+									if (!ok)
+									{
+										return;
+									}
+									const auto h = FindHeater(other);
+									if (h.IsNull())
+									{
+										return;
+									}
+									if (h->GetTuningFans().Intersects(fans))
+									{
+										reply.printf("cannot tune heater %u because heater %u is being tuned using the same fan", heaterNumber, other);
+										ok = false;
+									}
+									else if (isBedOrChamber && IsBedOrChamberHeater(other))
+									{
+										reply.printf("cannot tune heater %u because bed or chamber heater %u is being tuned", heaterNumber, other);
+										ok = false;
+									}
+#if SUPPORT_CAN_EXPANSION
+									else if (boardAddress != CanInterface::GetCanAddress() && h->GetBoardAddress() == boardAddress)
+									{
+										reply.printf("cannot tune heater %u because heater %u on the same board is being tuned", heaterNumber, other);
+										ok = false;
+									}
+#endif
+								});
+	return ok;
+}
+
 // Process M308
 GCodeResult Heat::ConfigureSensor(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
@@ -1122,6 +1492,7 @@ void Heat::DeleteSensor(unsigned int sn) noexcept
 			}
 			delete sensorToDelete;
 			--sensorCount;
+			scheduleChanged = true;
 			reprap.SensorsUpdated();
 			break;
 		}
@@ -1150,6 +1521,7 @@ void Heat::InsertSensor(TemperatureSensor *newSensor) noexcept
 				prev->SetNext(newSensor);
 			}
 			++sensorCount;
+			scheduleChanged = true;
 			reprap.SensorsUpdated();
 			break;
 		}
@@ -29,6 +29,7 @@ Licence: GPL
 #include <Platform/RepRap.h>
 #include "Heater.h"
 #include "TemperatureError.h"
+#include "HeatTimerWheel.h"
 #include <RTOSIface/RTOSIface.h>
 
 class TemperatureSensor;
@@ -47,6 +48,7 @@ public:
 	[[noreturn]] void HeaterTask() noexcept;
 	void Init() noexcept;												// Set everything up
 	void Exit() noexcept;												// Shut everything down
+	void HeaterScheduleChanged() noexcept { scheduleChanged = true; }	// Called when heaters or sensors are added or removed or a sample interval is changed
 	void ResetHeaterModels() noexcept;									// Reset all active heater models to defaults
 
 	bool ColdExtrude() const noexcept;									// Is cold extrusion allowed?
@@ -78,6 +80,7 @@ public:
 	GCodeResult ResetFault(int heater, const StringRef& reply) noexcept;	// Reset a heater fault for a specific heater or all heaters
 
 	GCodeResult SetOrReportHeaterModel(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);
+	GCodeResult ExportHeaterTelemetry(GCodeBuffer& gb, const StringRef& reply, OutputBuffer*& outBuf) THROWS(GCodeException);	// Report or save recent heater samples (M306)
 	GCodeResult TuneHeater(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);
 	GCodeResult ConfigureSensor(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);		// Create a sensor or change the parameters for an existing sensor
 	GCodeResult SetPidParameters(unsigned int heater, GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException); // Set the P/I/D parameters for a heater
@@ -85,6 +88,8 @@ public:
 
 	[[noreturn]] void SensorsTask() noexcept;
 	static void EnsureSensorsTask() noexcept;
+	[[noreturn]] void SpiSensorsTask() noexcept;
+	static void EnsureSpiSensorsTask() noexcept;
 
 	ReadLockedPointer<TemperatureSensor> FindSensor(int sn) const noexcept;	// Get a pointer to the temperature sensor entry
 	ReadLockedPointer<TemperatureSensor> FindSensorAtOrAbove(unsigned int sn) const noexcept;	// Get a pointer to the first temperature sensor with the specified or higher number
@@ -122,6 +127,13 @@ public:
 
 	GCodeResult ConfigureHeater(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);
 	GCodeResult ConfigureHeaterMonitoring(size_t heater, GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);
+	GCodeResult ConfigurePowerBudget(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);	// Set the total heater power (M570 W)
+	void ReportPowerBudget(const StringRef& reply) const noexcept;
+
+	float AllocateHeaterPower(unsigned int heater, float demandWatts, float priority) noexcept	// Called by a heater to get its share of the power budget
+	pre(heater < MaxHeaters);
+	void ReleaseHeaterPower(unsigned int heater) noexcept				// Called by a heater when it stops drawing power
+	pre(heater < MaxHeaters);
 
 	void SetActiveTemperature(int heater, float t) THROWS(GCodeException) { SetTemperature(heater, t, true); }
 	void SetStandbyTemperature(int heater, float t) THROWS(GCodeException) { SetTemperature(heater, t, false); }
@@ -130,6 +142,12 @@ public:
 	void SwitchOff(int heater) noexcept;								// Turn off a specific heater
 	void FeedForwardAdjustment(unsigned int heater, float fanPwmChange, float extrusionChange) const noexcept;
 
+#if SUPPORT_HEATER_SIMULATION
+	// Called by a local heater each time it sets its output, and by simulated heater sensors to find out what that heater is doing
+	void SetSimulatedHeaterOutput(unsigned int heater, float pwm, float target) noexcept { simulatedHeaterPwms[heater] = pwm; simulatedHeaterTargets[heater] = target; }
+	void GetSimulatedHeaterOutput(unsigned int heater, float& pwm, float& target) const noexcept { pwm = simulatedHeaterPwms[heater]; target = simulatedHeaterTargets[heater]; }
+#endif
+
 #if HAS_MASS_STORAGE
 	bool WriteModelParameters(FileStore *f) const noexcept;				// Write heater model parameters to file returning true if no error
 	bool WriteBedAndChamberTempSettings(FileStore *f) const noexcept;	// Save some resume information
@@ -158,6 +176,12 @@ private:
 	void DeleteSensor(unsigned int sn) noexcept;
 	void InsertSensor(TemperatureSensor *newSensor) noexcept;
 	void SetTemperature(int heater, float t, bool activeNotStandby) THROWS(GCodeException);
+	void RebuildSchedule() noexcept;
+	bool IsSensorReadPending(int sensorNumber) const noexcept;
+	bool CanTuneAlongsideOthers(unsigned int heaterNumber, FansBitmap fans, const StringRef& reply) const noexcept;
+#if SUPPORT_CAN_EXPANSION
+	void BroadcastSensorTemperatures() noexcept;
+#endif
 
 	static ReadWriteLock heatersLock;
 
@@ -172,8 +196,19 @@ private:
 	bool coldExtrude;											// Is cold extrusion allowed?
 	int8_t bedHeaters[MaxBedHeaters];							// Indices of the hot bed heaters to use or -1 if none is available
 	int8_t chamberHeaters[MaxChamberHeaters];					// Indices of the chamber heaters to use or -1 if none is available
-	int8_t heaterBeingTuned;									// which PID is currently being tuned
+	HeatersBitmap heatersBeingTuned;							// which heaters are currently being tuned
+	float heaterPowerBudget;									// the total power in watts that the heaters may draw, or 0 if there is no limit
+	float heaterPowerDemands[MaxHeaters];						// the power in watts that each heater most recently asked for
+	float heaterPowerPriorities[MaxHeaters];					// the priority that each heater most recently asked for power with
+	float heaterPowerGranted[MaxHeaters];						// the power in watts that each heater was most recently allowed
 	int8_t lastHeaterTuned;										// which PID we last finished tuning
+#if SUPPORT_HEATER_SIMULATION
+	float simulatedHeaterPwms[MaxHeaters];						// the PWM that each local heater most recently output
+	float simulatedHeaterTargets[MaxHeaters];					// the target temperature of each local heater when it last set its output, or 0 if it had none
+#endif
+
+	HeatTimerWheel timerWheel;									// Schedules the sensor polls and heater control loops. Only used by the heater task.
+	volatile bool scheduleChanged;								// Set when the timer wheel needs to be rebuilt
 };
 
 //***********************************************************************************************************
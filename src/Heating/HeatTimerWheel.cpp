@@ -0,0 +1,75 @@
+/*
+ * HeatTimerWheel.cpp
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#include "HeatTimerWheel.h"
+
+HeatTimerWheel::HeatTimerWheel() noexcept : currentTick(0)
+{
+	Clear();
+}
+
+void HeatTimerWheel::Clear() noexcept
+{
+	for (uint8_t& s : slots)
+	{
+		s = NoEntry;
+	}
+}
+
+void HeatTimerWheel::ScheduleHeater(size_t heater, uint32_t intervalMillis) noexcept
+{
+	Schedule(heater, intervalMillis);
+}
+
+void HeatTimerWheel::ScheduleSensor(size_t sensor, uint32_t intervalMillis) noexcept
+{
+	Schedule(MaxHeaters + sensor, intervalMillis);
+}
+
+// Add an entry that is not already in the wheel. It will be due on the next tick.
+void HeatTimerWheel::Schedule(size_t entryNumber, uint32_t intervalMillis) noexcept
+{
+	Entry& e = entries[entryNumber];
+	e.intervalTicks = max<uint32_t>(intervalMillis/HeatTaskTickMillis, 1);
+	e.dueTick = currentTick + 1;
+	Insert(entryNumber);
+}
+
+void HeatTimerWheel::Insert(size_t entryNumber) noexcept
+{
+	Entry& e = entries[entryNumber];
+	uint8_t& slot = slots[e.dueTick % NumSlots];
+	e.next = slot;
+	slot = (uint8_t)entryNumber;
+}
+
+void HeatTimerWheel::Tick(HeatersBitmap& dueHeaters, SensorsBitmap& dueSensors) noexcept
+{
+	++currentTick;
+	uint8_t entryNumber = slots[currentTick % NumSlots];
+	slots[currentTick % NumSlots] = NoEntry;
+	while (entryNumber != NoEntry)
+	{
+		Entry& e = entries[entryNumber];
+		const uint8_t next = e.next;
+		if (e.dueTick == currentTick)
+		{
+			if (entryNumber < MaxHeaters)
+			{
+				dueHeaters.SetBit(entryNumber);
+			}
+			else
+			{
+				dueSensors.SetBit(entryNumber - MaxHeaters);
+			}
+			e.dueTick += e.intervalTicks;
+		}
+		Insert(entryNumber);								// put it back, in this slot if it is due on a later revolution of the wheel
+		entryNumber = next;
+	}
+}
+
+// End
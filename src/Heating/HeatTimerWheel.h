@@ -0,0 +1,47 @@
+/*
+ * HeatTimerWheel.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ *  Timer wheel used by the heater task to schedule sensor polls and heater control loops that run at different intervals
+ */
+
+#ifndef SRC_HEATING_HEATTIMERWHEEL_H_
+#define SRC_HEATING_HEATTIMERWHEEL_H_
+
+#include <RepRapFirmware.h>
+
+// Each heater and each sensor has an entry. The wheel has one slot per tick of the heater task, and each slot holds a linked list of the entries due in that tick
+// or in a later revolution of the wheel. So each tick we only look at the entries in one slot, instead of checking every heater and sensor.
+class HeatTimerWheel
+{
+public:
+	HeatTimerWheel() noexcept;
+
+	void Clear() noexcept;																// Remove all entries from the wheel
+	void ScheduleHeater(size_t heater, uint32_t intervalMillis) noexcept pre(heater < MaxHeaters);
+	void ScheduleSensor(size_t sensor, uint32_t intervalMillis) noexcept pre(sensor < MaxSensors);
+	void Tick(HeatersBitmap& dueHeaters, SensorsBitmap& dueSensors) noexcept;			// Advance by one tick and return the heaters and sensors that are due
+
+private:
+	static constexpr size_t NumSlots = 64;												// 640ms per revolution when the tick is 10ms
+	static constexpr size_t NumEntries = MaxHeaters + MaxSensors;						// heaters first, then sensors
+	static constexpr uint8_t NoEntry = 0xFF;
+	static_assert(NumEntries < NoEntry, "Too many heaters and sensors for the timer wheel");
+
+	struct Entry
+	{
+		uint32_t dueTick;
+		uint16_t intervalTicks;
+		uint8_t next;
+	};
+
+	void Schedule(size_t entryNumber, uint32_t intervalMillis) noexcept;
+	void Insert(size_t entryNumber) noexcept;
+
+	uint32_t currentTick;
+	uint8_t slots[NumSlots];
+	Entry entries[NumEntries];
+};
+
+#endif /* SRC_HEATING_HEATTIMERWHEEL_H_ */
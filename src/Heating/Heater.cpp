@@ -15,6 +15,10 @@
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <GCodes/GCodeException.h>
 
+#if SUPPORT_CAN_EXPANSION
+# include "CAN/CanInterface.h"
+#endif
+
 #if SUPPORT_OBJECT_MODEL
 
 // Object model table and functions
@@ -61,38 +65,8 @@ DEFINE_GET_OBJECT_MODEL_TABLE(Heater)
 
 #endif
 
-// Static members of class Heater
-
-float Heater::tuningPwm;								// the PWM to use, 0..1
-float Heater::tuningTargetTemp;							// the target temperature
-float Heater::tuningHysteresis;
-float Heater::tuningFanPwm;
-
-DeviationAccumulator Heater::tuningStartTemp;			// the temperature when we turned on the heater
-DeviationAccumulator Heater::dHigh;
-DeviationAccumulator Heater::dLow;
-DeviationAccumulator Heater::tOn;
-DeviationAccumulator Heater::tOff;
-DeviationAccumulator Heater::heatingRate;
-DeviationAccumulator Heater::coolingRate;
-DeviationAccumulator Heater::tuningVoltage;				// sum of the voltage readings we take during the heating phase
-
-uint32_t Heater::tuningBeginTime;						// when we started the tuning process
-uint32_t Heater::lastOffTime;
-uint32_t Heater::lastOnTime;
-float Heater::peakTemp;									// max or min temperature
-uint32_t Heater::peakTime;								// the time at which we recorded peakTemp
-float Heater::afterPeakTemp;							// temperature after max from which we start timing the cooling rate
-uint32_t Heater::afterPeakTime;							// the time at which we recorded afterPeakTemp
-float Heater::lastCoolingRate;
-FansBitmap Heater::tuningFans;
-unsigned int Heater::tuningPhase;
-uint8_t Heater::idleCyclesDone;
-
-Heater::HeaterParameters Heater::fanOffParams, Heater::fanOnParams;
-
 // Clear all the counters except tuning voltage and start temperature
-/*static*/ void Heater::ClearCounters() noexcept
+void Heater::TuningData::ClearCounters() noexcept
 {
 	dHigh.Clear();
 	dLow.Clear();
@@ -103,8 +77,8 @@ Heater::HeaterParameters Heater::fanOffParams, Heater::fanOnParams;
 }
 
 Heater::Heater(unsigned int num) noexcept
-	: tuned(false), heaterNumber(num), sensorNumber(-1), activeTemperature(0.0), standbyTemperature(0.0),
-	  maxTempExcursion(DefaultMaxTempExcursion), maxHeatingFaultTime(DefaultMaxHeatingFaultTime),
+	: tuned(false), tuning(nullptr), heaterNumber(num), sensorNumber(-1), activeTemperature(0.0), standbyTemperature(0.0),
+	  maxTempExcursion(DefaultMaxTempExcursion), maxHeatingFaultTime(DefaultMaxHeatingFaultTime), ratedPower(0.0), sampleIntervalMillis(HeatSampleIntervalMillis),
 	  active(false), modelSetByUser(false), monitorsSetByUser(false)
 {
 }
@@ -115,8 +89,18 @@ Heater::~Heater() noexcept
 	{
 		h.Disable();
 	}
+	delete tuning;
+}
+
+#if SUPPORT_CAN_EXPANSION
+
+CanAddress Heater::GetBoardAddress() const noexcept
+{
+	return CanInterface::GetCanAddress();
 }
 
+#endif
+
 void Heater::SetSensorNumber(int sn) noexcept
 {
 	if (sn != sensorNumber)
@@ -125,6 +109,19 @@ void Heater::SetSensorNumber(int sn) noexcept
 	}
 }
 
+// Set the interval between calls to Spin. Overridden by heaters that can't support this.
+GCodeResult Heater::SetSampleInterval(uint32_t intervalMillis, const StringRef& reply) noexcept
+{
+	if (intervalMillis < MinHeatSampleIntervalMillis || intervalMillis > MaxHeatSampleIntervalMillis)
+	{
+		reply.printf("sample interval must be between %" PRIu32 " and %" PRIu32 "ms", MinHeatSampleIntervalMillis, MaxHeatSampleIntervalMillis);
+		return GCodeResult::error;
+	}
+	sampleIntervalMillis = (intervalMillis/HeatTaskTickMillis) * HeatTaskTickMillis;
+	reprap.GetHeat().HeaterScheduleChanged();
+	return GCodeResult::ok;
+}
+
 GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
 	bool seen = false;
@@ -133,8 +130,9 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		maxPwm = model.GetMaxPwm(),
 		voltage = model.GetVoltage();
 	float coolingRates[2] = { model.GetCoolingRateFanOff(), model.GetCoolingRateFanOn() };
-	int32_t dontUsePid = model.UsePid() ? 0 : 1;
+	int32_t controlMode = (!model.UsePid()) ? 1 : (model.UseMpc()) ? 2 : 0;		// B0 = PID, B1 = bang-bang, B2 = model predictive control
 	int32_t inversionParameter = 0;
+	float extrusionCoefficient = model.GetExtrusionCoefficient();
 
 	// Get the cooling time constant(s) first
 	float timeConstants[2];
@@ -163,18 +161,82 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		heatingRate = gain * coolingRates[0];
 	}
 	gb.TryGetFValue('D', td, seen);
-	gb.TryGetIValue('B', dontUsePid, seen);
+	gb.TryGetIValue('B', controlMode, seen);
+#if SUPPORT_CAN_EXPANSION
+	if (controlMode == 2 && GetBoardAddress() != CanInterface::GetCanAddress())
+	{
+		reply.copy("model predictive control is not supported on remote heaters");
+		return GCodeResult::error;
+	}
+#endif
 	gb.TryGetFValue('S', maxPwm, seen);
 	gb.TryGetFValue('V', voltage, seen);
 	gb.TryGetIValue('I', inversionParameter, seen);
+	if (controlMode == 2 && (inversionParameter == 1 || inversionParameter == 3))
+	{
+		reply.copy("model predictive control is not supported with inverted temperature control");
+		return GCodeResult::error;
+	}
+
+	// The sample interval, rated power and extrusion feedforward coefficient aren't part of the process model, so they can be set on their own
+	if (gb.Seen('W'))
+	{
+		const float watts = gb.GetFValue();
+		if (watts < 0.0)
+		{
+			reply.copy("heater power must not be negative");
+			return GCodeResult::error;
+		}
+		ratedPower = watts;
+		if (!seen && !gb.Seen('Q') && !gb.Seen('E'))
+		{
+			return GCodeResult::ok;
+		}
+	}
+
+	if (gb.Seen('Q'))
+	{
+		const GCodeResult rslt = SetSampleInterval(gb.GetUIValue(), reply);
+		if (rslt != GCodeResult::ok || (!seen && !gb.Seen('E')))
+		{
+			return rslt;
+		}
+	}
+
+	bool seenExtrusionCoefficient = false;
+	gb.TryGetFValue('E', extrusionCoefficient, seenExtrusionCoefficient);
+	if (seenExtrusionCoefficient)
+	{
+		if (extrusionCoefficient < 0.0)
+		{
+			reply.copy("extrusion coefficient must not be negative");
+			return GCodeResult::error;
+		}
+#if SUPPORT_CAN_EXPANSION
+		if (GetBoardAddress() != CanInterface::GetCanAddress())
+		{
+			reply.copy("extrusion feedforward is not supported on remote heaters");
+			return GCodeResult::error;
+		}
+#endif
+		if (!seen)
+		{
+			model.SetExtrusionCoefficient(extrusionCoefficient);
+			reprap.HeatUpdated();
+			return GCodeResult::ok;
+		}
+	}
 
 	if (seen)
 	{
 		// Set the model
 		const bool inverseTemperatureControl = (inversionParameter == 1 || inversionParameter == 3);
-		const GCodeResult rslt = SetModel(heatingRate, coolingRates[0], coolingRates[1], td, maxPwm, voltage, dontUsePid == 0, inverseTemperatureControl, reply);
+		const bool usePid = (controlMode == 0 || controlMode == 2);
+		const GCodeResult rslt = SetModel(heatingRate, coolingRates[0], coolingRates[1], td, maxPwm, voltage, usePid, inverseTemperatureControl, reply);
 		if (rslt <= GCodeResult::warning)
 		{
+			model.SetUseMpc(controlMode == 2);
+			model.SetExtrusionCoefficient(extrusionCoefficient);
 			modelSetByUser = true;
 		}
 		return rslt;
@@ -188,6 +250,7 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 	else
 	{
 		const char* const mode = (!model.UsePid()) ? "bang-bang"
+									: (model.UseMpc()) ? "model predictive"
 									: (model.ArePidParametersOverridden()) ? "custom PID"
 										: "PID";
 		reply.printf("Heater %u model: heating rate %.3f, cooling time constant %.1f", heater, (double)model.GetHeatingRate(), (double)model.GetTimeConstantFanOff());
@@ -200,6 +263,15 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		{
 			reply.cat(", inverted control");
 		}
+		if (model.GetExtrusionCoefficient() > 0.0)
+		{
+			reply.catf(", extrusion coefficient %.4f", (double)model.GetExtrusionCoefficient());
+		}
+		reply.catf(", sample interval %ums", (unsigned int)sampleIntervalMillis);
+		if (ratedPower > 0.0)
+		{
+			reply.catf(", power %.1fW", (double)ratedPower);
+		}
 		if (model.UsePid())
 		{
 			M301PidParameters params = model.GetM301PidParameters(false);
@@ -283,18 +355,23 @@ GCodeResult Heater::StartAutoTune(GCodeBuffer& gb, const StringRef& reply, FansB
 		reply.printf("Target temperature must be at least 20C above ambient temperature");
 	}
 
-	// Get abd store the optional parameters
-	tuningTargetTemp = targetTemp;
-	tuningFans = fans;
-	tuningPwm = (gb.Seen('P')) ? gb.GetLimitedFValue('P', 0.1, 1.0) : GetModel().GetMaxPwm();
-	tuningHysteresis = (gb.Seen('Y')) ? gb.GetLimitedFValue('Y', 1.0, 20.0) : DefaultTuningHysteresis;
-	tuningFanPwm = (gb.Seen('F')) ? gb.GetLimitedFValue('F', 0.1, 1.0) : 1.0;
+	if (tuning == nullptr)
+	{
+		tuning = new TuningData;
+	}
+
+	// Get and store the optional parameters
+	tuning->targetTemp = targetTemp;
+	tuning->fans = fans;
+	tuning->pwm = (gb.Seen('P')) ? gb.GetLimitedFValue('P', 0.1, 1.0) : GetModel().GetMaxPwm();
+	tuning->hysteresis = (gb.Seen('Y')) ? gb.GetLimitedFValue('Y', 1.0, 20.0) : DefaultTuningHysteresis;
+	tuning->fanPwm = (gb.Seen('F')) ? gb.GetLimitedFValue('F', 0.1, 1.0) : 1.0;
 
 	const GCodeResult rslt = StartAutoTune(reply, seenA, ambientTemp);
 	if (rslt == GCodeResult::ok)
 	{
 		reply.printf("Auto tuning heater %u using target temperature %.1f" DEGREE_SYMBOL "C and PWM %.2f - do not leave printer unattended",
-						GetHeaterNumber(), (double)targetTemp, (double)tuningPwm);
+						GetHeaterNumber(), (double)targetTemp, (double)tuning->pwm);
 	}
 	return rslt;
 }
@@ -314,11 +391,11 @@ const char *const Heater::TuningPhaseText[] =
 // Get the auto tune status or last result
 void Heater::GetAutoTuneStatus(const StringRef& reply) const noexcept
 {
-	if (GetStatus() == HeaterStatus::tuning)
+	if (GetStatus() == HeaterStatus::tuning && tuning != nullptr)
 	{
 		// Phases are: 1 = stabilising, 2 = heating, 3 = settling, 4 = cycling with fan off, 5 = cycling with fan on
-		const unsigned int numPhases = (tuningFans.IsEmpty()) ? 4 : ARRAY_SIZE(TuningPhaseText);
-		reply.printf("Heater %u is being tuned, phase %u of %u, %s", GetHeaterNumber(), tuningPhase + 1, numPhases, TuningPhaseText[tuningPhase]);
+		const unsigned int numPhases = (tuning->fans.IsEmpty()) ? 4 : ARRAY_SIZE(TuningPhaseText);
+		reply.printf("Heater %u is being tuned, phase %u of %u, %s", GetHeaterNumber(), tuning->phase + 1, numPhases, TuningPhaseText[tuning->phase]);
 	}
 	else if (tuned)
 	{
@@ -330,12 +407,18 @@ void Heater::GetAutoTuneStatus(const StringRef& reply) const noexcept
 	}
 }
 
+// Get the fans that the current or most recent auto tune of this heater uses
+FansBitmap Heater::GetTuningFans() const noexcept
+{
+	return (tuning == nullptr) ? FansBitmap() : tuning->fans;
+}
+
 // Tell the user what's happening, called after the tuning phase has been updated
 void Heater::ReportTuningUpdate() noexcept
 {
-	if (tuningPhase < ARRAY_SIZE(TuningPhaseText))
+	if (tuning->phase < ARRAY_SIZE(TuningPhaseText))
 	{
-		reprap.GetPlatform().MessageF(GenericMessage, "Auto tune starting phase %u, %s\n", tuningPhase + 1, TuningPhaseText[tuningPhase]);
+		reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune starting phase %u, %s\n", GetHeaterNumber(), tuning->phase + 1, TuningPhaseText[tuning->phase]);
 	}
 }
 
@@ -352,40 +435,40 @@ void Heater::CalculateModel(HeaterParameters& params) noexcept
 										" V %.1f" PLUS_OR_MINUS "%.1f,"
 #endif
 										" cycles %u\n",
-										lrintf(tOn.GetMean()), lrintf(tOn.GetDeviation()),
-										lrintf(tOff.GetMean()), lrintf(tOff.GetDeviation()),
-										lrintf(dHigh.GetMean()), lrintf(dHigh.GetDeviation()),
-										lrintf(dLow.GetMean()), lrintf(dLow.GetDeviation()),
-										(double)heatingRate.GetMean(), (double)heatingRate.GetDeviation(),
-										(double)coolingRate.GetMean(), (double)coolingRate.GetDeviation(),
+										lrintf(tuning->tOn.GetMean()), lrintf(tuning->tOn.GetDeviation()),
+										lrintf(tuning->tOff.GetMean()), lrintf(tuning->tOff.GetDeviation()),
+										lrintf(tuning->dHigh.GetMean()), lrintf(tuning->dHigh.GetDeviation()),
+										lrintf(tuning->dLow.GetMean()), lrintf(tuning->dLow.GetDeviation()),
+										(double)tuning->heatingRate.GetMean(), (double)tuning->heatingRate.GetDeviation(),
+										(double)tuning->coolingRate.GetMean(), (double)tuning->coolingRate.GetDeviation(),
 #if HAS_VOLTAGE_MONITOR
-										(double)tuningVoltage.GetMean(), (double)tuningVoltage.GetDeviation(),
+										(double)tuning->voltage.GetMean(), (double)tuning->voltage.GetDeviation(),
 #endif
-										coolingRate.GetNumSamples()
+										tuning->coolingRate.GetNumSamples()
 									 );
 	}
 
-	const float cycleTime = tOn.GetMean() + tOff.GetMean();		// in milliseconds
-	const float averageTemperatureRiseHeating = tuningTargetTemp - 0.5 * (tuningHysteresis - TuningPeakTempDrop) - tuningStartTemp.GetMean();
-	const float averageTemperatureRiseCooling = tuningTargetTemp - TuningPeakTempDrop - 0.5 * tuningHysteresis - tuningStartTemp.GetMean();
-	params.deadTime = (((dHigh.GetMean() * tOff.GetMean()) + (dLow.GetMean() * tOn.GetMean())) * MillisToSeconds)/cycleTime;	// in seconds
-	params.coolingRate = coolingRate.GetMean()/averageTemperatureRiseCooling;			// in seconds
-	params.heatingRate = (heatingRate.GetMean() + (coolingRate.GetMean() * averageTemperatureRiseHeating/averageTemperatureRiseCooling)) / tuningPwm;
-	params.numCycles = dHigh.GetNumSamples();
+	const float cycleTime = tuning->tOn.GetMean() + tuning->tOff.GetMean();		// in milliseconds
+	const float averageTemperatureRiseHeating = tuning->targetTemp - 0.5 * (tuning->hysteresis - TuningPeakTempDrop) - tuning->startTemp.GetMean();
+	const float averageTemperatureRiseCooling = tuning->targetTemp - TuningPeakTempDrop - 0.5 * tuning->hysteresis - tuning->startTemp.GetMean();
+	params.deadTime = (((tuning->dHigh.GetMean() * tuning->tOff.GetMean()) + (tuning->dLow.GetMean() * tuning->tOn.GetMean())) * MillisToSeconds)/cycleTime;	// in seconds
+	params.coolingRate = tuning->coolingRate.GetMean()/averageTemperatureRiseCooling;			// in seconds
+	params.heatingRate = (tuning->heatingRate.GetMean() + (tuning->coolingRate.GetMean() * averageTemperatureRiseHeating/averageTemperatureRiseCooling)) / tuning->pwm;
+	params.numCycles = tuning->dHigh.GetNumSamples();
 }
 
 void Heater::SetAndReportModel(bool usingFans) noexcept
 {
-	const float hRate = (usingFans) ? (fanOffParams.heatingRate + fanOnParams.heatingRate) * 0.5 : fanOffParams.heatingRate;
-	const float deadTime = (usingFans) ? (fanOffParams.deadTime + fanOnParams.deadTime) * 0.5 : fanOffParams.deadTime;
+	const float hRate = (usingFans) ? (tuning->fanOffParams.heatingRate + tuning->fanOnParams.heatingRate) * 0.5 : tuning->fanOffParams.heatingRate;
+	const float deadTime = (usingFans) ? (tuning->fanOffParams.deadTime + tuning->fanOnParams.deadTime) * 0.5 : tuning->fanOffParams.deadTime;
 
-	float fanOnCoolingRate = fanOffParams.coolingRate;
+	float fanOnCoolingRate = tuning->fanOffParams.coolingRate;
 	if (usingFans)
 	{
 		// Sometimes the print cooling fan makes no difference to the cooling rate. The SetModel call will fail if the rate with fan on is lower than the rate with fan off.
-		if (fanOnParams.coolingRate > fanOffParams.coolingRate)
+		if (tuning->fanOnParams.coolingRate > tuning->fanOffParams.coolingRate)
 		{
-			fanOnCoolingRate = fanOffParams.coolingRate + (fanOnParams.coolingRate - fanOffParams.coolingRate)/tuningFanPwm;
+			fanOnCoolingRate = tuning->fanOffParams.coolingRate + (tuning->fanOnParams.coolingRate - tuning->fanOffParams.coolingRate)/tuning->fanPwm;
 		}
 		else
 		{
@@ -395,11 +478,11 @@ void Heater::SetAndReportModel(bool usingFans) noexcept
 
 	String<StringLength256> str;
 	const GCodeResult rslt = SetModel(	hRate,
-										fanOffParams.coolingRate, fanOnCoolingRate,
+										tuning->fanOffParams.coolingRate, fanOnCoolingRate,
 										deadTime,
-										tuningPwm,
+										tuning->pwm,
 #if HAS_VOLTAGE_MONITOR
-										tuningVoltage.GetMean(),
+										tuning->voltage.GetMean(),
 #else
 										0.0,
 #endif
@@ -410,9 +493,9 @@ void Heater::SetAndReportModel(bool usingFans) noexcept
 		str.printf("Auto tuning heater %u completed after %u idle and %u tuning cycles in %" PRIu32 " seconds. This heater needs the following M307 command:\n"
 					" M307 H%u B0 R%.3f C%.1f",
 					GetHeaterNumber(),
-					idleCyclesDone,
-					(usingFans) ? fanOffParams.numCycles + fanOnParams.numCycles : fanOffParams.numCycles,
-					(millis() - tuningBeginTime)/(uint32_t)SecondsToMillis,
+					tuning->idleCyclesDone,
+					(usingFans) ? tuning->fanOffParams.numCycles + tuning->fanOnParams.numCycles : tuning->fanOffParams.numCycles,
+					(millis() - tuning->beginTime)/(uint32_t)SecondsToMillis,
 					GetHeaterNumber(), (double)GetModel().GetHeatingRate(), (double)(1.0/GetModel().GetCoolingRateFanOff())
 				  );
 		if (usingFans)
@@ -434,8 +517,8 @@ void Heater::SetAndReportModel(bool usingFans) noexcept
 	{
 		reprap.GetPlatform().MessageF(WarningMessage, "Auto tune of heater %u failed due to bad curve fit (R=%.3f, 1/C=%.4f:%.4f, D=%.1f)\n",
 										GetHeaterNumber(), (double)hRate,
-										(double)fanOffParams.coolingRate, (double)fanOnCoolingRate,
-										(double)fanOffParams.deadTime);
+										(double)tuning->fanOffParams.coolingRate, (double)fanOnCoolingRate,
+										(double)tuning->fanOffParams.deadTime);
 	}
 }
 
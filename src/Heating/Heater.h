@@ -22,6 +22,7 @@
 #define TUNE_WITH_HALF_FAN	0
 
 class HeaterMonitor;
+class HeaterTelemetry;
 struct CanMessageHeaterTuningReport;
 struct CanHeaterReport;
 
@@ -48,14 +49,19 @@ public:
 	virtual void Suspend(bool sus) noexcept = 0;						// Suspend the heater to conserve power or while doing Z probing
 	virtual float GetAccumulator() const noexcept = 0;					// Get the inertial term accumulator
 	virtual void FeedForwardAdjustment(float fanPwmChange, float extrusionChange) noexcept = 0;
+	virtual GCodeResult SetSampleInterval(uint32_t intervalMillis, const StringRef& reply) noexcept;	// Set how often Spin is called
 
 #if SUPPORT_CAN_EXPANSION
 	virtual void UpdateRemoteStatus(CanAddress src, const CanHeaterReport& report) noexcept = 0;
 	virtual void UpdateHeaterTuning(CanAddress src, const CanMessageHeaterTuningReport& msg) noexcept = 0;
+	virtual CanAddress GetBoardAddress() const noexcept;				// Get the address of the board that the heater is on. Overridden for remote heaters.
 #endif
 
 	HeaterStatus GetStatus() const noexcept;							// Get the status of the heater
 	unsigned int GetHeaterNumber() const noexcept { return heaterNumber; }
+	uint32_t GetSampleIntervalMillis() const noexcept { return sampleIntervalMillis; }	// Get the interval between calls to Spin
+	float GetRatedPower() const noexcept { return ratedPower; }			// Get the power in watts at full PWM, or 0 if not known
+	int GetSensorNumber() const noexcept { return sensorNumber; }		// Get the number of the sensor used by this heater
 	const char *GetSensorName() const noexcept;							// Get the name of the sensor for this heater, or nullptr if it hasn't been named
 	void SetTemperature(float t, bool activeNotStandby) THROWS(GCodeException);
 	float GetActiveTemperature() const noexcept { return activeTemperature; }
@@ -65,6 +71,8 @@ public:
 	GCodeResult StartAutoTune(GCodeBuffer& gb, const StringRef& reply, FansBitmap fans) THROWS(GCodeException);
 																		// Start an auto tune cycle for this heater
 	void GetAutoTuneStatus(const StringRef& reply) const noexcept;		// Get the auto tune status or last result
+	FansBitmap GetTuningFans() const noexcept;							// Get the fans used by the current or last auto tune
+	virtual const HeaterTelemetry *GetTelemetry() const noexcept { return nullptr; }	// Get the recent control loop samples, if this heater records them
 
 	void GetFaultDetectionParameters(float& pMaxTempExcursion, float& pMaxFaultTime) const noexcept
 		{ pMaxTempExcursion = maxTempExcursion; pMaxFaultTime = maxHeatingFaultTime; }
@@ -127,7 +135,6 @@ protected:
 	virtual GCodeResult UpdateHeaterMonitors(const StringRef& reply) noexcept = 0;
 	virtual GCodeResult StartAutoTune(const StringRef& reply, bool seenA, float ambientTemp) noexcept = 0;
 
-	int GetSensorNumber() const noexcept { return sensorNumber; }
 	void SetSensorNumber(int sn) noexcept;
 	float GetMaxTemperatureExcursion() const noexcept { return maxTempExcursion; }
 	float GetMaxHeatingFaultTime() const noexcept { return maxHeatingFaultTime; }
@@ -152,36 +159,41 @@ protected:
 	static constexpr float FeedForwardMultiplier = 1.3;		// how much we over-compensate feedforward to allow for heat reservoirs during tuning
 	static constexpr float HeaterSettledCoolingTimeRatio = 0.93;
 
-	// Variables used during heater tuning
-	static float tuningPwm;									// the PWM to use, 0..1
-	static float tuningTargetTemp;							// the target temperature
-	static float tuningHysteresis;
-	static float tuningFanPwm;
-
-	static DeviationAccumulator tuningStartTemp;			// the temperature when we turned on the heater
-	static uint32_t tuningBeginTime;						// when we started the tuning process
-	static DeviationAccumulator dHigh;
-	static DeviationAccumulator dLow;
-	static DeviationAccumulator tOn;
-	static DeviationAccumulator tOff;
-	static DeviationAccumulator heatingRate;
-	static DeviationAccumulator coolingRate;
-	static DeviationAccumulator tuningVoltage;				// sum of the voltage readings we take during the heating phase
-
-	static uint32_t lastOffTime;
-	static uint32_t lastOnTime;
-	static float peakTemp;									// max or min temperature
-	static uint32_t peakTime;								// the time at which we recorded peakTemp
-	static float afterPeakTemp;								// temperature after max from which we start timing the cooling rate
-	static uint32_t afterPeakTime;							// the time at which we recorded afterPeakTemp
-	static float lastCoolingRate;
-	static FansBitmap tuningFans;
-	static unsigned int tuningPhase;
-	static uint8_t idleCyclesDone;
-
-	static HeaterParameters fanOffParams, fanOnParams;
-
-	static void ClearCounters() noexcept;
+	// Variables used during heater tuning. Each heater has its own set so that several heaters can be tuned at once.
+	struct TuningData
+	{
+		float pwm;											// the PWM to use, 0..1
+		float targetTemp;									// the target temperature
+		float hysteresis;
+		float fanPwm;
+
+		DeviationAccumulator startTemp;						// the temperature when we turned on the heater
+		uint32_t beginTime;									// when we started the tuning process
+		DeviationAccumulator dHigh;
+		DeviationAccumulator dLow;
+		DeviationAccumulator tOn;
+		DeviationAccumulator tOff;
+		DeviationAccumulator heatingRate;
+		DeviationAccumulator coolingRate;
+		DeviationAccumulator voltage;						// sum of the voltage readings we take during the heating phase
+
+		uint32_t lastOffTime;
+		uint32_t lastOnTime;
+		float peakTemp;										// max or min temperature
+		uint32_t peakTime;									// the time at which we recorded peakTemp
+		float afterPeakTemp;								// temperature after max from which we start timing the cooling rate
+		uint32_t afterPeakTime;								// the time at which we recorded afterPeakTemp
+		float lastCoolingRate;
+		FansBitmap fans;
+		unsigned int phase;
+		uint8_t idleCyclesDone;
+
+		HeaterParameters fanOffParams, fanOnParams;
+
+		void ClearCounters() noexcept;
+	};
+
+	TuningData *tuning;										// allocated the first time this heater is tuned and kept until it is deleted
 
 private:
 	static const char* const TuningPhaseText[];
@@ -193,6 +205,8 @@ private:
 	float standbyTemperature;						// The required standby temperature
 	float maxTempExcursion;							// The maximum temperature excursion permitted while maintaining the setpoint
 	float maxHeatingFaultTime;						// How long a heater fault is permitted to persist before a heater fault is raised
+	float ratedPower;								// The power in watts that the heater draws at full PWM, or 0 if not known
+	uint16_t sampleIntervalMillis;					// How often the heater task samples the temperature and runs the control loop
 
 	bool active;									// Are we active or standby?
 	bool modelSetByUser;
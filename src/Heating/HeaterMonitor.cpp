@@ -16,8 +16,8 @@ HeaterMonitor::HeaterMonitor() noexcept
 {
 }
 
-// Check if any action needs to be taken. Returns true if everything is OK
-bool HeaterMonitor::Check() noexcept
+// Check if any action needs to be taken. Returns true if everything is OK. This is called once per sample interval of the heater.
+bool HeaterMonitor::Check(uint32_t sampleIntervalMillis) noexcept
 {
 	if (sensorNumber >= 0 && trigger != HeaterMonitorTrigger::Disabled)
 	{
@@ -26,8 +26,11 @@ bool HeaterMonitor::Check() noexcept
 
 		if (err != TemperatureError::success)
 		{
-			badTemperatureCount++;
-			if (badTemperatureCount > MaxBadTemperatureCount)
+			if (badTemperatureCount < 255)
+			{
+				badTemperatureCount++;
+			}
+			if (badTemperatureCount * sampleIntervalMillis > MaxBadTemperatureMillis)
 			{
 				reprap.GetPlatform().MessageF(ErrorMessage, "Temperature reading error on sensor %d\n", sensorNumber);
 				return false;
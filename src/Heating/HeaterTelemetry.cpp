@@ -0,0 +1,133 @@
+/*
+ * HeaterTelemetry.cpp
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#include "HeaterTelemetry.h"
+#include <Platform/OutputMemory.h>
+
+#if HAS_MASS_STORAGE
+# include <Storage/FileStore.h>
+#endif
+
+// Add a record. This is only called by the heater task, so it doesn't need a lock. The record is complete before numRecorded changes.
+void HeaterTelemetry::Add(uint32_t now, float temperature, float setpoint, float pwm, float feedForward, uint8_t mode) noexcept
+{
+	const uint32_t seq = numRecorded;
+	Record& r = records[seq % HeaterTelemetryRecords];
+	r.time = now;
+	r.temperature = (int16_t)constrain<long>(lrintf(temperature * 10.0), INT16_MIN, INT16_MAX);
+	r.setpoint = (int16_t)constrain<long>(lrintf(setpoint * 10.0), INT16_MIN, INT16_MAX);
+	r.pwm = (uint8_t)constrain<long>(lrintf(pwm * 255.0), 0, 255);
+	r.feedForward = (uint8_t)constrain<long>(lrintf(feedForward * 255.0), 0, 255);
+	r.mode = mode;
+	r.reserved = 0;
+	numRecorded = seq + 1;
+}
+
+// Get the sequence number of the first record to export, given the maximum number of records wanted
+uint32_t HeaterTelemetry::GetFirstToExport(size_t maxRecords) const noexcept
+{
+	const uint32_t seq = numRecorded;
+	return (seq > maxRecords) ? seq - maxRecords : 0;
+}
+
+// Copy up to maxRecords records starting at sequence number seq, returning the number copied.
+// If some of the records we were asked for have been overwritten then seq is advanced to the oldest one we still have.
+size_t HeaterTelemetry::CopyRecords(uint32_t& seq, Record *buffer, size_t maxRecords) const noexcept
+{
+	TaskCriticalSectionLocker lock;
+
+	const uint32_t newest = numRecorded;
+	if (newest - seq > HeaterTelemetryRecords)
+	{
+		seq = newest - HeaterTelemetryRecords;
+	}
+	size_t numCopied = 0;
+	while (numCopied < maxRecords && seq + numCopied != newest)
+	{
+		buffer[numCopied] = records[(seq + numCopied) % HeaterTelemetryRecords];
+		++numCopied;
+	}
+	return numCopied;
+}
+
+/*static*/ void HeaterTelemetry::FormatCsvLine(const StringRef& line, const Record& r) noexcept
+{
+	line.printf("%" PRIu32 ",%.1f,%.1f,%.3f,%.3f,%u\n",
+				r.time, (double)((float)r.temperature * 0.1), (double)((float)r.setpoint * 0.1),
+				(double)((float)r.pwm * (1.0/255.0)), (double)((float)r.feedForward * (1.0/255.0)), r.mode);
+}
+
+// Append the most recent records to an output buffer in CSV format
+void HeaterTelemetry::AppendCsv(OutputBuffer *buf, size_t maxRecords) const noexcept
+{
+	buf->cat(CsvHeader);
+	uint32_t seq = GetFirstToExport(maxRecords);
+	Record chunk[RecordsPerCopy];
+	String<StringLength50> line;
+	for (;;)
+	{
+		const size_t numCopied = CopyRecords(seq, chunk, min<size_t>(RecordsPerCopy, maxRecords));
+		if (numCopied == 0)
+		{
+			break;
+		}
+		for (size_t i = 0; i < numCopied; ++i)
+		{
+			FormatCsvLine(line.GetRef(), chunk[i]);
+			buf->cat(line.c_str());
+		}
+		seq += numCopied;
+		maxRecords -= numCopied;
+	}
+}
+
+#if HAS_MASS_STORAGE
+
+// Write the most recent records to a file in CSV or binary format, returning true if successful.
+// A binary file is the header string followed by the records in little-endian order, oldest first.
+bool HeaterTelemetry::WriteToFile(FileStore *f, bool binary, size_t maxRecords) const noexcept
+{
+	if (!f->Write((binary) ? BinaryFileHeader : CsvHeader))
+	{
+		return false;
+	}
+
+	uint32_t seq = GetFirstToExport(maxRecords);
+	Record chunk[RecordsPerCopy];
+	String<StringLength50> line;
+	for (;;)
+	{
+		const size_t numCopied = CopyRecords(seq, chunk, min<size_t>(RecordsPerCopy, maxRecords));
+		if (numCopied == 0)
+		{
+			return true;
+		}
+		if (binary)
+		{
+			if (!f->Write(reinterpret_cast<const uint8_t *>(chunk), numCopied * sizeof(Record)))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < numCopied; ++i)
+			{
+				FormatCsvLine(line.GetRef(), chunk[i]);
+				if (!f->Write(line.c_str()))
+				{
+					return false;
+				}
+			}
+		}
+		seq += numCopied;
+		maxRecords -= numCopied;
+	}
+}
+
+#endif
+
+// End
@@ -0,0 +1,58 @@
+/*
+ * HeaterTelemetry.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ *  Ring buffer that records what a heater's control loop did in each sample, so that oscillations can be diagnosed after the event
+ */
+
+#ifndef SRC_HEATING_HEATERTELEMETRY_H_
+#define SRC_HEATING_HEATERTELEMETRY_H_
+
+#include <RepRapFirmware.h>
+
+class OutputBuffer;
+
+// The heater task adds one record each time the heater's control loop runs. Records are small and are added without locking,
+// so recording can be left on all the time. Readers copy the records they want inside a critical section and skip any that
+// the heater task has overwritten since they started.
+class HeaterTelemetry
+{
+public:
+	struct Record
+	{
+		uint32_t time;										// millis() when the sample was taken
+		int16_t temperature;								// tenths of a degree C
+		int16_t setpoint;									// tenths of a degree C, or 0 if the heater wasn't controlling to a target
+		uint8_t pwm;										// the PWM output, scaled to 0..255
+		uint8_t feedForward;								// the part of the PWM that was feedforward, scaled to 0..255
+		uint8_t mode;										// the HeaterMode
+		uint8_t reserved;
+	};
+	static_assert(sizeof(Record) == 12, "Heater telemetry records must be packed because they are written to binary files");
+
+	HeaterTelemetry() noexcept : numRecorded(0) { }
+
+	void Reset() noexcept { numRecorded = 0; }
+	void Add(uint32_t now, float temperature, float setpoint, float pwm, float feedForward, uint8_t mode) noexcept;
+
+	void AppendCsv(OutputBuffer *buf, size_t maxRecords) const noexcept;
+#if HAS_MASS_STORAGE
+	bool WriteToFile(FileStore *f, bool binary, size_t maxRecords) const noexcept;
+#endif
+
+	static constexpr const char *BinaryFileHeader = "RRFHTL1\n";
+	static constexpr const char *CsvHeader = "time,temperature,setpoint,pwm,feedforward,mode\n";
+
+private:
+	static constexpr size_t RecordsPerCopy = 16;
+
+	uint32_t GetFirstToExport(size_t maxRecords) const noexcept;
+	size_t CopyRecords(uint32_t& seq, Record *buffer, size_t maxRecords) const noexcept;
+	static void FormatCsvLine(const StringRef& line, const Record& r) noexcept;
+
+	volatile uint32_t numRecorded;							// the total number of records added, used as a sequence number
+	Record records[HeaterTelemetryRecords];
+};
+
+#endif /* SRC_HEATING_HEATERTELEMETRY_H_ */
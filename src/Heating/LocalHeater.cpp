@@ -10,9 +10,11 @@
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include "Heat.h"
 #include "HeaterMonitor.h"
+#include "Sensors/TemperatureSensor.h"
 #include <Platform/Platform.h>
 #include <Platform/RepRap.h>
 #include <Tools/Tool.h>
+#include <Movement/Move.h>
 
 // Member functions and constructors
 
@@ -45,6 +47,9 @@ float LocalHeater::GetAccumulator() const noexcept
 inline void LocalHeater::SetHeater(float power) const noexcept
 {
 	port.WriteAnalog(power);
+#if SUPPORT_HEATER_SIMULATION
+	reprap.GetHeat().SetSimulatedHeaterOutput(GetHeaterNumber(), power, (mode >= HeaterMode::heating && mode <= HeaterMode::stable) ? GetTargetTemperature() : 0.0);
+#endif
 }
 
 void LocalHeater::ResetHeater() noexcept
@@ -57,6 +62,11 @@ void LocalHeater::ResetHeater() noexcept
 	averagePWM = lastPwm = 0.0;
 	heatingFaultCount = 0;
 	temperature = BadErrorTemperature;
+	extrusionFeedForwardPwm = mpcDisturbance = mpcPwmSum = 0.0;
+	memset(mpcPwmHistory, 0, sizeof(mpcPwmHistory));
+	mpcHistoryIndex = mpcSamplesInSlot = 0;
+	samplesSincePreviousTemperature = 0;
+	reprap.GetHeat().ReleaseHeaterPower(GetHeaterNumber());
 }
 
 // Configure the heater port and the sensor number
@@ -140,6 +150,7 @@ GCodeResult LocalHeater::SwitchOn(const StringRef& reply) noexcept
 void LocalHeater::SwitchOff() noexcept
 {
 	lastPwm = 0.0;
+	reprap.GetHeat().ReleaseHeaterPower(GetHeaterNumber());
 	if (GetModel().IsEnabled())
 	{
 		SetHeater(0.0);
@@ -163,18 +174,24 @@ GCodeResult LocalHeater::UpdateModel(const StringRef& reply) noexcept
 // This is the main heater control loop function
 void LocalHeater::Spin() noexcept
 {
+	const uint32_t now = millis();
+	const uint32_t sampleInterval = GetSampleIntervalMillis();
+
 	// Read the temperature even if the heater is suspended or the model is not enabled
 	const TemperatureError err = ReadTemperature();
 
 	// Handle any temperature reading error and calculate the temperature rate of change, if possible
 	if (err != TemperatureError::success)
 	{
-		previousTemperaturesGood <<= 1;				// this reading isn't a good one
+		RecordPreviousTemperature(false, now);		// this reading isn't a good one
 		if (mode > HeaterMode::suspended)			// don't worry about errors when reading heaters that are switched off or flagged as having faults
 		{
 			// Error may be a temporary error and may correct itself after a few additional reads
-			badTemperatureCount++;
-			if (badTemperatureCount > MaxBadTemperatureCount)
+			if (badTemperatureCount < 255)
+			{
+				badTemperatureCount++;
+			}
+			if (badTemperatureCount * sampleInterval > MaxBadTemperatureMillis)
 			{
 				RaiseHeaterFault("Temperature reading fault on heater %u: %s\n", GetHeaterNumber(), TemperatureErrorString(err));
 			}
@@ -189,8 +206,8 @@ void LocalHeater::Spin() noexcept
 		badTemperatureCount = 0;
 		if ((previousTemperaturesGood & (1 << (NumPreviousTemperatures - 1))) != 0)
 		{
-			const float tentativeDerivative = (SecondsToMillis/(float)HeatSampleIntervalMillis) * (temperature - previousTemperatures[previousTemperatureIndex])
-							/ (float)(NumPreviousTemperatures);
+			const float tentativeDerivative = SecondsToMillis * (temperature - previousTemperatures[previousTemperatureIndex])
+							/ (float)(now - previousTemperatureTimes[previousTemperatureIndex]);
 			// Some sensors give occasional temperature spikes. We don't expect the temperature to increase by more than 10C/second.
 			if (fabsf(tentativeDerivative) <= 10.0)
 			{
@@ -198,8 +215,7 @@ void LocalHeater::Spin() noexcept
 				gotDerivative = true;
 			}
 		}
-		previousTemperatures[previousTemperatureIndex] = temperature;
-		previousTemperaturesGood = (previousTemperaturesGood << 1) | 1;
+		RecordPreviousTemperature(true, now);
 
 		if (GetModel().IsEnabled())
 		{
@@ -224,7 +240,7 @@ void LocalHeater::Spin() noexcept
 							&& (float)(millis() - timeSetHeating) > GetModel().GetDeadTime() * SecondsToMillis * 2)
 						{
 							++heatingFaultCount;
-							if (heatingFaultCount * HeatSampleIntervalMillis > GetMaxHeatingFaultTime() * SecondsToMillis)
+							if (heatingFaultCount * sampleInterval > GetMaxHeatingFaultTime() * SecondsToMillis)
 							{
 								RaiseHeaterFault("Heater %u fault: temperature rising much more slowly than the expected %.1f" DEGREE_SYMBOL "C/sec\n",
 													GetHeaterNumber(), (double)expectedRate);
@@ -246,7 +262,7 @@ void LocalHeater::Spin() noexcept
 				if (fabsf(error) > GetMaxTemperatureExcursion() && temperature > MaxAmbientTemperature)
 				{
 					++heatingFaultCount;
-					if (heatingFaultCount * HeatSampleIntervalMillis > GetMaxHeatingFaultTime() * SecondsToMillis)
+					if (heatingFaultCount * sampleInterval > GetMaxHeatingFaultTime() * SecondsToMillis)
 					{
 						RaiseHeaterFault("Heater %u fault: temperature excursion exceeded %.1f" DEGREE_SYMBOL "C (target %.1f" DEGREE_SYMBOL "C, actual %.1f" DEGREE_SYMBOL "C)\n",
 											GetHeaterNumber(), (double)GetMaxTemperatureExcursion(), (double)targetTemperature, (double)temperature);
@@ -277,6 +293,7 @@ void LocalHeater::Spin() noexcept
 			}
 
 			// Calculate the PWM
+			extrusionFeedForwardPwm = 0.0;
 			if (mode >= HeaterMode::tuning0)
 			{
 				DoTuningStep();
@@ -300,7 +317,15 @@ void LocalHeater::Spin() noexcept
 						const float errorMinusDterm = error - (params.tD * derivative);
 						const float pPlusD = params.kP * errorMinusDterm;
 						const float expectedPwm = constrain<float>((temperature - NormalAmbientTemperature)/GetModel().GetGainFanOff(), 0.0, GetModel().GetMaxPwm());
-						if (pPlusD + expectedPwm > GetModel().GetMaxPwm())
+						if (mode == HeaterMode::stable && !GetModel().IsInverted())
+						{
+							extrusionFeedForwardPwm = GetExtrusionFeedForwardPwm();
+						}
+						if (GetModel().UseMpc())
+						{
+							lastPwm = min<float>(GetModelPredictivePwm(targetTemperature, derivative, gotDerivative) + extrusionFeedForwardPwm, GetModel().GetMaxPwm());
+						}
+						else if (pPlusD + expectedPwm > GetModel().GetMaxPwm())
 						{
 							lastPwm = GetModel().GetMaxPwm();
 							// If we are heating up, preset the I term to the expected PWM at this temperature, ready for the switch over to PID
@@ -317,9 +342,9 @@ void LocalHeater::Spin() noexcept
 						{
 							const float errorToUse = error;
 							iAccumulator = constrain<float>
-											(iAccumulator + (errorToUse * params.kP * params.recipTi * (HeatSampleIntervalMillis * MillisToSeconds)),
-												0.0, GetModel().GetMaxPwm());
-							lastPwm = constrain<float>(pPlusD + iAccumulator, 0.0, GetModel().GetMaxPwm());
+											(iAccumulator + (errorToUse * params.kP * params.recipTi * (sampleInterval * MillisToSeconds)),
+												-extrusionFeedForwardPwm, GetModel().GetMaxPwm() - extrusionFeedForwardPwm);
+							lastPwm = constrain<float>(pPlusD + iAccumulator + extrusionFeedForwardPwm, 0.0, GetModel().GetMaxPwm());
 						}
 #if HAS_VOLTAGE_MONITOR
 						// Scale the PID based on the current voltage vs. the calibration voltage
@@ -353,7 +378,7 @@ void LocalHeater::Spin() noexcept
 				for (size_t i = 0; i < ARRAY_SIZE(monitors); ++i)
 				{
 					HeaterMonitor& prot = monitors[i];
-					if (!prot.Check())
+					if (!prot.Check(sampleInterval))
 					{
 						lastPwm = 0.0;
 						switch (prot.GetAction())
@@ -387,10 +412,25 @@ void LocalHeater::Spin() noexcept
 			lastPwm = 0.0;
 		}
 
-		// Set the heater power and update the average PWM
+		// Limit the power if the heaters would otherwise draw more than the power budget allows
+		if (GetRatedPower() > 0.0)
+		{
+			lastPwm = reprap.GetHeat().AllocateHeaterPower(GetHeaterNumber(), lastPwm * GetRatedPower(), GetPowerPriority())/GetRatedPower();
+		}
+
+		// Set the heater power, record what we did and update the average PWM
 		SetHeater(lastPwm);
-		averagePWM = averagePWM * (1.0 - HeatSampleIntervalMillis/(HeatPwmAverageTime * SecondsToMillis)) + lastPwm;
-		previousTemperatureIndex = (previousTemperatureIndex + 1) % NumPreviousTemperatures;
+		telemetry.Add(now, temperature, (mode >= HeaterMode::heating && mode <= HeaterMode::stable) ? GetTargetTemperature() : 0.0, lastPwm, extrusionFeedForwardPwm, (uint8_t)mode);
+		averagePWM = averagePWM * (1.0 - sampleInterval/(HeatPwmAverageTime * SecondsToMillis)) + lastPwm;
+		mpcPwmSum += max<float>(lastPwm - extrusionFeedForwardPwm, 0.0);		// the feedforward isn't part of the model
+		++mpcSamplesInSlot;
+		if (mpcSamplesInSlot >= GetMpcSamplesPerSlot())
+		{
+			mpcPwmHistory[mpcHistoryIndex] = (uint8_t)lrintf((mpcPwmSum/mpcSamplesInSlot) * 255.0);
+			mpcHistoryIndex = (mpcHistoryIndex + 1) % MpcHistoryLength;
+			mpcPwmSum = 0.0;
+			mpcSamplesInSlot = 0;
+		}
 
 		// For temperature sensors which do not require frequent sampling and averaging,
 		// their temperature is read here and error/safety handling performed.  However,
@@ -398,7 +438,7 @@ void LocalHeater::Spin() noexcept
 		// runs the risk of having undesirable delays between calls.  To guard against this,
 		// we record for each PID object when it was last sampled and have the Tick ISR
 		// take action if there is a significant delay since the time of last sampling.
-		lastSampleTime = millis();
+		lastSampleTime = now;
 
 //  	debugPrintf("Heater %d: e=%f, P=%f, I=%f, d=%f, r=%f\n", heater, error, pp.kP*error, temp_iState, temp_dState, result);
 	}
@@ -417,7 +457,22 @@ GCodeResult LocalHeater::ResetFault(const StringRef& reply) noexcept
 
 float LocalHeater::GetAveragePWM() const noexcept
 {
-	return averagePWM * HeatSampleIntervalMillis/(HeatPwmAverageTime * SecondsToMillis);
+	return averagePWM * GetSampleIntervalMillis()/(HeatPwmAverageTime * SecondsToMillis);
+}
+
+// Get the priority of this heater when the power budget is shared out. Heaters that are holding their temperature or being tuned come first,
+// then heaters that are warming up, in order of how long they would take to reach their target temperatures at full power.
+float LocalHeater::GetPowerPriority() const noexcept
+{
+	if (mode == HeaterMode::stable || mode >= HeaterMode::tuning0)
+	{
+		return HeaterPowerPriorityHolding;
+	}
+	if (mode == HeaterMode::heating)
+	{
+		return max<float>((GetTargetTemperature() - temperature)/GetModel().GetHeatingRate(), 0.0);
+	}
+	return 0.0;
 }
 
 // Get a conservative estimate of the expected heating rate at the current temperature and average PWM. The result may be negative.
@@ -431,7 +486,92 @@ float LocalHeater::GetExpectedHeatingRate() const noexcept
 			: 0.0;
 }
 
-// Auto tune this heater. The caller has already checked that no other heater is being tuned and has set up tuningTargetTemp, tuningPwm, tuningFans, tuningHysteresis and tuningFanPwm.
+// Record a temperature reading for use in later derivative calculations. At short sample intervals we don't record every reading,
+// so that the derivative is always calculated over a similar length of time.
+void LocalHeater::RecordPreviousTemperature(bool good, uint32_t now) noexcept
+{
+	++samplesSincePreviousTemperature;
+	if (!good || samplesSincePreviousTemperature * GetSampleIntervalMillis() >= PreviousTemperatureIntervalMillis)
+	{
+		previousTemperatures[previousTemperatureIndex] = temperature;
+		previousTemperatureTimes[previousTemperatureIndex] = now;
+		previousTemperaturesGood = (previousTemperaturesGood << 1) | ((good) ? 1 : 0);
+		previousTemperatureIndex = (previousTemperatureIndex + 1) % NumPreviousTemperatures;
+		samplesSincePreviousTemperature = 0;
+	}
+}
+
+// Get how many samples each slot of the PWM history covers. At short sample intervals or long dead times we average several samples
+// into each slot, so that the history always covers the dead time.
+unsigned int LocalHeater::GetMpcSamplesPerSlot() const noexcept
+{
+	const uint32_t historyMillis = GetSampleIntervalMillis() * (MpcHistoryLength - 2);
+	const uint32_t deadTimeMillis = (uint32_t)(GetModel().GetDeadTime() * SecondsToMillis);
+	return constrain<unsigned int>((deadTimeMillis + historyMillis - 1)/historyMillis, 1, 255);
+}
+
+// Get the average PWM we output in the given slot of the PWM history, where 1 means the most recent slot
+float LocalHeater::GetPastPwm(size_t slotsAgo) const noexcept
+{
+	return (float)mpcPwmHistory[(mpcHistoryIndex + MpcHistoryLength - slotsAgo) % MpcHistoryLength] * (1.0/255.0);
+}
+
+// Calculate the extra PWM needed to heat the filament that we expect to be extruded one dead time from now, so that the extra power
+// reaches the melt zone at the same time as the extra filament does
+float LocalHeater::GetExtrusionFeedForwardPwm() const noexcept
+{
+	const float coefficient = GetModel().GetExtrusionCoefficient();
+	if (coefficient <= 0.0)
+	{
+		return 0.0;
+	}
+
+	const float filamentRate = reprap.GetMove().GetMainDDARing().GetFutureExtrusionRate(GetHeaterNumber(),
+																					(uint32_t)(GetModel().GetDeadTime() * (float)StepTimer::GetTickRate()),
+																					ExtrusionFeedForwardWindowMillis * (StepTimer::GetTickRate()/1000));
+	const float filamentDiameter = reprap.GetPlatform().GetFilamentWidth();
+	const float volumetricRate = filamentRate * fsquare(filamentDiameter) * (Pi/4.0);
+	return min<float>(volumetricRate * coefficient, GetModel().GetMaxPwm());
+}
+
+// Calculate the PWM using model predictive control. This is predictive functional control with a single coincidence point:
+// 1. Predict the temperature one dead time ahead from the current temperature and the PWM we have already output during the last dead time.
+// 2. Choose the constant PWM that brings the temperature at the end of the prediction horizon onto a first order reference trajectory towards the target.
+// Differences between the measured rate of change and the model's prediction are integrated into a disturbance term, so that
+// errors in the model, extra cooling and extrusion don't cause a steady state offset.
+float LocalHeater::GetModelPredictivePwm(float targetTemperature, float derivative, bool gotDerivative) noexcept
+{
+	const FopDt& model = GetModel();
+	const float sampleInterval = GetSampleIntervalMillis() * MillisToSeconds;
+	const float slotInterval = sampleInterval * GetMpcSamplesPerSlot();
+	const float heatingRate = model.GetHeatingRate();
+	const float coolingRate = model.GetCoolingRateFanOff();
+	const float deadTime = model.GetDeadTime();
+	const size_t deadTimeSlots = constrain<long>(lrintf(deadTime/slotInterval), 1, MpcHistoryLength - 1);
+
+	if (gotDerivative)
+	{
+		const float modelRate = heatingRate * GetPastPwm(deadTimeSlots + 1) - coolingRate * (temperature - NormalAmbientTemperature) + mpcDisturbance;
+		const float newDisturbance = mpcDisturbance + (derivative - modelRate) * sampleInterval/(MpcDisturbanceTimeFactor * deadTime + sampleInterval);
+		TaskCriticalSectionLocker lock;			// FeedForwardAdjustment may change mpcDisturbance too
+		mpcDisturbance = constrain<float>(newDisturbance, -heatingRate, heatingRate);
+	}
+
+	float predictedTemperature = temperature;
+	for (size_t i = deadTimeSlots; i != 0; --i)
+	{
+		predictedTemperature += slotInterval * (heatingRate * GetPastPwm(i) - coolingRate * (predictedTemperature - NormalAmbientTemperature) + mpcDisturbance);
+	}
+
+	const float horizon = max<float>(deadTime, 2 * sampleInterval);
+	const float decay = expf(-coolingRate * horizon);
+	const float reference = targetTemperature - (targetTemperature - predictedTemperature) * expf(-horizon/deadTime);
+	const float effectiveAmbient = NormalAmbientTemperature + mpcDisturbance/coolingRate;
+	const float pwm = coolingRate * (reference - effectiveAmbient - (predictedTemperature - effectiveAmbient) * decay)/(heatingRate * (1.0 - decay));
+	return constrain<float>(pwm, 0.0, model.GetMaxPwm());
+}
+
+// Auto tune this heater. The caller has already checked that this heater can be tuned alongside any others being tuned and has set up the tuning parameters.
 GCodeResult LocalHeater::StartAutoTune(const StringRef& reply, bool seenA, float ambientTemp) noexcept
 {
 	if (lastPwm > 0.0 || GetAveragePWM() > 0.02)
@@ -440,25 +580,25 @@ GCodeResult LocalHeater::StartAutoTune(const StringRef& reply, bool seenA, float
 		return GCodeResult::error;
 	}
 
-	reprap.GetFansManager().SetFansValue(tuningFans, 0.0);
+	reprap.GetFansManager().SetFansValue(tuning->fans, 0.0);
 
-	tuningStartTemp.Clear();
-	tuningBeginTime = millis();
+	tuning->startTemp.Clear();
+	tuning->beginTime = millis();
 	tuned = false;					// assume failure
 
 	if (seenA)
 	{
-		tuningStartTemp.Add(ambientTemp);
-		ClearCounters();
+		tuning->startTemp.Add(ambientTemp);
+		tuning->ClearCounters();
 		timeSetHeating = millis();
-		lastPwm = tuningPwm;										// turn on heater at specified power
-		tuningPhase = 1;
+		lastPwm = tuning->pwm;										// turn on heater at specified power
+		tuning->phase = 1;
 		mode = HeaterMode::tuning1;
 		ReportTuningUpdate();
 	}
 	else
 	{
-		tuningPhase = 0;
+		tuning->phase = 0;
 		mode = HeaterMode::tuning0;
 	}
 
@@ -471,6 +611,14 @@ void LocalHeater::FeedForwardAdjustment(float fanPwmChange, float extrusionChang
 	if (mode == HeaterMode::stable)
 	{
 		const float coolingRateIncrease = GetModel().GetCoolingRateChangeFanOn() * fanPwmChange;
+		if (GetModel().UseMpc())
+		{
+			// Tell the model predictive controller about the extra cooling straight away instead of waiting for it to see the temperature drop
+			TaskCriticalSectionLocker lock;
+			mpcDisturbance -= coolingRateIncrease * (GetTargetTemperature() - NormalAmbientTemperature);
+			return;
+		}
+
 		const float boost = (coolingRateIncrease * (GetTargetTemperature() - NormalAmbientTemperature) * FeedForwardMultiplier)/GetModel().GetHeatingRate();
 #if 0
 		if (reprap.Debug(moduleHeat))
@@ -526,188 +674,188 @@ void LocalHeater::DoTuningStep() noexcept
 	switch (mode)
 	{
 	case HeaterMode::tuning0:		// Waiting for initial temperature to settle after any thermostatic fans have turned on
-		if (tuningStartTemp.GetNumSamples() < 5000/HeatSampleIntervalMillis)
+		if (tuning->startTemp.GetNumSamples() < 5000/GetSampleIntervalMillis())
 		{
-			tuningStartTemp.Add(temperature);							// take another reading until we have samples temperatures for 5 seconds
+			tuning->startTemp.Add(temperature);							// take another reading until we have samples temperatures for 5 seconds
 			return;
 		}
 
-		if (tuningStartTemp.GetDeviation() <= 2.0)
+		if (tuning->startTemp.GetDeviation() <= 2.0)
 		{
 			timeSetHeating = now;
-			lastPwm = tuningPwm;										// turn on heater at specified power
+			lastPwm = tuning->pwm;										// turn on heater at specified power
 			mode = HeaterMode::tuning1;
 
-			reprap.GetPlatform().Message(GenericMessage, "Auto tune starting phase 1, heater on\n");
+			reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune starting phase 1, heater on\n", GetHeaterNumber());
 			return;
 		}
 
-		if (now - tuningBeginTime < 20000)
+		if (now - tuning->beginTime < 20000)
 		{
 			// Allow up to 20 seconds for starting temperature to settle
 			return;
 		}
 
-		reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because starting temperature is not stable\n");
+		reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because starting temperature is not stable\n", GetHeaterNumber());
 		break;
 
 	case HeaterMode::tuning1:		// Heating up
-		tuningPhase = 1;
+		tuning->phase = 1;
 		{
 			const bool isBedOrChamberHeater = reprap.GetHeat().IsBedOrChamberHeater(GetHeaterNumber());
 			const uint32_t heatingTime = now - timeSetHeating;
 			const float extraTimeAllowed = (isBedOrChamberHeater) ? 120.0 : 30.0;
-			if (heatingTime > (uint32_t)((GetModel().GetDeadTime() + extraTimeAllowed) * SecondsToMillis) && (temperature - tuningStartTemp.GetMean()) < 3.0)
+			if (heatingTime > (uint32_t)((GetModel().GetDeadTime() + extraTimeAllowed) * SecondsToMillis) && (temperature - tuning->startTemp.GetMean()) < 3.0)
 			{
-				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because temperature is not increasing\n");
+				reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because temperature is not increasing\n", GetHeaterNumber());
 				break;
 			}
 
 			const uint32_t timeoutMinutes = (isBedOrChamberHeater) ? 30 : 7;
 			if (heatingTime >= timeoutMinutes * 60 * (uint32_t)SecondsToMillis)
 			{
-				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because target temperature was not reached\n");
+				reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because target temperature was not reached\n", GetHeaterNumber());
 				break;
 			}
 
-			if (temperature >= tuningTargetTemp)							// if reached target
+			if (temperature >= tuning->targetTemp)							// if reached target
 			{
 				// Move on to next phase
 				lastPwm = 0.0;
 				SetHeater(0.0);
-				peakTemp = afterPeakTemp = temperature;
-				lastOffTime = peakTime = afterPeakTime = now;
-				tuningVoltage.Clear();
-				idleCyclesDone = 0;
+				tuning->peakTemp = tuning->afterPeakTemp = temperature;
+				tuning->lastOffTime = tuning->peakTime = tuning->afterPeakTime = now;
+				tuning->voltage.Clear();
+				tuning->idleCyclesDone = 0;
 				mode = HeaterMode::tuning2;
-				tuningPhase = 2;
+				tuning->phase = 2;
 				ReportTuningUpdate();
 			}
 		}
 		return;
 
 	case HeaterMode::tuning2:		// Heater is off, record the peak temperature and time
-		if (temperature >= peakTemp)
+		if (temperature >= tuning->peakTemp)
 		{
-			peakTemp = afterPeakTemp = temperature;
-			peakTime = afterPeakTime = now;
+			tuning->peakTemp = tuning->afterPeakTemp = temperature;
+			tuning->peakTime = tuning->afterPeakTime = now;
 		}
-		else if (temperature < tuningTargetTemp - tuningHysteresis)
+		else if (temperature < tuning->targetTemp - tuning->hysteresis)
 		{
 			// Temperature has dropped below the low limit.
 			// If we have been doing idle cycles, see whether we can switch to collecting data, and turn the heater on.
 			// If we have been collecting data, see if we have enough, and either turn the heater on to start another cycle or finish tuning.
 
 			// Save the data (don't know whether we need it yet)
-			dHigh.Add((float)(peakTime - lastOffTime));
-			tOff.Add((float)(now - lastOffTime));
-			const float currentCoolingRate = (afterPeakTemp - temperature) * SecondsToMillis/(now - afterPeakTime);
-			coolingRate.Add(currentCoolingRate);
+			tuning->dHigh.Add((float)(tuning->peakTime - tuning->lastOffTime));
+			tuning->tOff.Add((float)(now - tuning->lastOffTime));
+			const float currentCoolingRate = (tuning->afterPeakTemp - temperature) * SecondsToMillis/(now - tuning->afterPeakTime);
+			tuning->coolingRate.Add(currentCoolingRate);
 
 			// Decide whether to finish this phase
-			if (tuningPhase == 2)				// if we are doing idle cycles
+			if (tuning->phase == 2)				// if we are doing idle cycles
 			{
 				// To allow for heat reservoirs, we do idle cycles until the cooling rate decreases by no more than a certain amount in a single cycle
-				if (idleCyclesDone == TuningHeaterMaxIdleCycles || (idleCyclesDone >= TuningHeaterMinIdleCycles && currentCoolingRate >= lastCoolingRate * HeaterSettledCoolingTimeRatio))
+				if (tuning->idleCyclesDone == TuningHeaterMaxIdleCycles || (tuning->idleCyclesDone >= TuningHeaterMinIdleCycles && currentCoolingRate >= tuning->lastCoolingRate * HeaterSettledCoolingTimeRatio))
 				{
-					tuningPhase = 3;
+					tuning->phase = 3;
 					ReportTuningUpdate();
 				}
 				else
 				{
-					lastCoolingRate = currentCoolingRate;
-					ClearCounters();
-					++idleCyclesDone;
+					tuning->lastCoolingRate = currentCoolingRate;
+					tuning->ClearCounters();
+					++tuning->idleCyclesDone;
 				}
 			}
-			else if (coolingRate.GetNumSamples() >= MinTuningHeaterCycles)
+			else if (tuning->coolingRate.GetNumSamples() >= MinTuningHeaterCycles)
 			{
-				const bool isConsistent = dLow.DeviationFractionWithin(0.2)
-										&& dHigh.DeviationFractionWithin(0.2)
-										&& heatingRate.DeviationFractionWithin(0.1)
-										&& coolingRate.DeviationFractionWithin(0.1);
-				if (isConsistent || coolingRate.GetNumSamples() == MaxTuningHeaterCycles)
+				const bool isConsistent = tuning->dLow.DeviationFractionWithin(0.2)
+										&& tuning->dHigh.DeviationFractionWithin(0.2)
+										&& tuning->heatingRate.DeviationFractionWithin(0.1)
+										&& tuning->coolingRate.DeviationFractionWithin(0.1);
+				if (isConsistent || tuning->coolingRate.GetNumSamples() == MaxTuningHeaterCycles)
 				{
 					if (!isConsistent)
 					{
 						reprap.GetPlatform().Message(WarningMessage, "heater behaviour was not consistent during tuning\n");
 					}
 
-					if (tuningPhase == 3)
+					if (tuning->phase == 3)
 					{
-						CalculateModel(fanOffParams);
-						if (tuningFans.IsEmpty())
+						CalculateModel(tuning->fanOffParams);
+						if (tuning->fans.IsEmpty())
 						{
 							SetAndReportModel(false);
 							break;
 						}
 						else
 						{
-							tuningPhase = 4;
-							ClearCounters();
+							tuning->phase = 4;
+							tuning->ClearCounters();
 #if TUNE_WITH_HALF_FAN
-							reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm * 0.5);	// turn fans on at half PWM
+							reprap.GetFansManager().SetFansValue(tuning->fans, tuning->fanPwm * 0.5);	// turn fans on at half PWM
 #else
-							reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm);		// turn fans on at full PWM
+							reprap.GetFansManager().SetFansValue(tuning->fans, tuning->fanPwm);		// turn fans on at full PWM
 #endif
 							ReportTuningUpdate();
 						}
 					}
 #if TUNE_WITH_HALF_FAN
-					else if (tuningPhase == 4)
+					else if (tuning->phase == 4)
 					{
-						CalculateModel(fanOnParams);
-						tuningPhase = 5;
-						ClearCounters();
-						reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm);			// turn fans fully on
+						CalculateModel(tuning->fanOnParams);
+						tuning->phase = 5;
+						tuning->ClearCounters();
+						reprap.GetFansManager().SetFansValue(tuning->fans, tuning->fanPwm);			// turn fans fully on
 						ReportTuningUpdate();
 					}
 #endif
 					else
 					{
-						reprap.GetFansManager().SetFansValue(tuningFans, 0.0);					// turn fans off
-						CalculateModel(fanOnParams);
+						reprap.GetFansManager().SetFansValue(tuning->fans, 0.0);					// turn fans off
+						CalculateModel(tuning->fanOnParams);
 						SetAndReportModel(true);
 						break;
 					}
 				}
 			}
-			lastOnTime = peakTime = afterPeakTime = now;
-			peakTemp = afterPeakTemp = temperature;
-			lastPwm = tuningPwm;						// turn on heater at specified power
+			tuning->lastOnTime = tuning->peakTime = tuning->afterPeakTime = now;
+			tuning->peakTemp = tuning->afterPeakTemp = temperature;
+			lastPwm = tuning->pwm;						// turn on heater at specified power
 			mode = HeaterMode::tuning3;
 		}
-		else if (afterPeakTime == peakTime && tuningTargetTemp - temperature >= TuningPeakTempDrop)
+		else if (tuning->afterPeakTime == tuning->peakTime && tuning->targetTemp - temperature >= TuningPeakTempDrop)
 		{
-			afterPeakTime = now;
-			afterPeakTemp = temperature;
+			tuning->afterPeakTime = now;
+			tuning->afterPeakTemp = temperature;
 		}
 		return;
 
 	case HeaterMode::tuning3:	// Heater is turned on, record the lowest temperature and time
 #if HAS_VOLTAGE_MONITOR
-		tuningVoltage.Add(reprap.GetPlatform().GetCurrentPowerVoltage());
+		tuning->voltage.Add(reprap.GetPlatform().GetCurrentPowerVoltage());
 #endif
-		if (temperature <= peakTemp)
+		if (temperature <= tuning->peakTemp)
 		{
-			peakTemp = afterPeakTemp = temperature;
-			peakTime = afterPeakTime = now;
+			tuning->peakTemp = tuning->afterPeakTemp = temperature;
+			tuning->peakTime = tuning->afterPeakTime = now;
 		}
-		else if (temperature >= tuningTargetTemp)
+		else if (temperature >= tuning->targetTemp)
 		{
 			// We have reached the target temperature, so record a data point and turn the heater off
-			dLow.Add((float)(peakTime - lastOnTime));
-			tOn.Add((float)(now - lastOnTime));
-			heatingRate.Add((temperature - afterPeakTemp) * SecondsToMillis/(now - afterPeakTime));
-			lastOffTime = peakTime = afterPeakTime = now;
-			peakTemp = afterPeakTemp = temperature;
+			tuning->dLow.Add((float)(tuning->peakTime - tuning->lastOnTime));
+			tuning->tOn.Add((float)(now - tuning->lastOnTime));
+			tuning->heatingRate.Add((temperature - tuning->afterPeakTemp) * SecondsToMillis/(now - tuning->afterPeakTime));
+			tuning->lastOffTime = tuning->peakTime = tuning->afterPeakTime = now;
+			tuning->peakTemp = tuning->afterPeakTemp = temperature;
 			lastPwm = 0.0;								// turn heater off
 			mode = HeaterMode::tuning2;
 		}
-		else if (afterPeakTime == peakTime && temperature - tuningTargetTemp >= TuningPeakTempDrop - tuningHysteresis)
+		else if (tuning->afterPeakTime == tuning->peakTime && temperature - tuning->targetTemp >= TuningPeakTempDrop - tuning->hysteresis)
 		{
-			afterPeakTime = now;
-			afterPeakTemp = temperature;
+			tuning->afterPeakTime = now;
+			tuning->afterPeakTemp = temperature;
 		}
 		return;
 
@@ -744,6 +892,7 @@ void LocalHeater::RaiseHeaterFault(const char *format, ...) noexcept
 {
 	lastPwm = 0.0;
 	SetHeater(0.0);
+	reprap.GetHeat().ReleaseHeaterPower(GetHeaterNumber());
 	if (mode != HeaterMode::fault)
 	{
 		mode = HeaterMode::fault;
@@ -15,13 +15,17 @@
 #include "Heater.h"
 #include "FOPDT.h"
 #include "TemperatureError.h"
+#include "HeaterTelemetry.h"
 #include <Hardware/IoPorts.h>
 
 class HeaterMonitor;
 
 class LocalHeater : public Heater
 {
-	static const size_t NumPreviousTemperatures = 4;		// How many samples we average the temperature derivative over
+	static const size_t NumPreviousTemperatures = 4;		// How many recorded temperatures we average the temperature derivative over
+	static constexpr uint32_t PreviousTemperatureIntervalMillis = HeatSampleIntervalMillis;	// Minimum interval between recorded temperatures, so that the derivative isn't too noisy at short sample intervals
+	static const size_t MpcHistoryLength = 64;				// How many slots of PWM history we keep for model predictive control
+	static constexpr float MpcDisturbanceTimeFactor = 4.0;	// Time constant of the model predictive control disturbance estimate, in dead times
 
 public:
 	LocalHeater(unsigned int heaterNum) noexcept;
@@ -39,6 +43,7 @@ public:
 	float GetAccumulator() const noexcept override;							// Return the integral accumulator
 	void Suspend(bool sus) noexcept override;								// Suspend the heater to conserve power or while doing Z probing
 	void FeedForwardAdjustment(float fanPwmChange, float extrusionChange) noexcept override;
+	const HeaterTelemetry *GetTelemetry() const noexcept override { return &telemetry; }
 
 #if SUPPORT_CAN_EXPANSION
 	void UpdateRemoteStatus(CanAddress src, const CanHeaterReport& report) noexcept override { }
@@ -59,17 +64,31 @@ private:
 	TemperatureError ReadTemperature() noexcept;			// Read and store the temperature of this heater
 	void DoTuningStep() noexcept;							// Called on each temperature sample when auto tuning
 	float GetExpectedHeatingRate() const noexcept;			// Get the minimum heating rate we expect
+	float GetPowerPriority() const noexcept;				// Get the priority of this heater when sharing out the power budget
 	void RaiseHeaterFault(const char *format, ...) noexcept;
+	float GetModelPredictivePwm(float targetTemperature, float derivative, bool gotDerivative) noexcept;
+	float GetPastPwm(size_t slotsAgo) const noexcept;		// Get the average PWM we output in the given history slot
+	unsigned int GetMpcSamplesPerSlot() const noexcept;		// Get how many samples each slot of the PWM history covers
+	void RecordPreviousTemperature(bool good, uint32_t now) noexcept;
+	float GetExtrusionFeedForwardPwm() const noexcept;
 
 	PwmPort port;											// The port that drives the heater
 	float temperature;										// The current temperature
 	float previousTemperatures[NumPreviousTemperatures]; 	// The temperatures of the previous NumDerivativeSamples measurements, used for calculating the derivative
+	uint32_t previousTemperatureTimes[NumPreviousTemperatures];	// When we recorded the previous temperatures
 	size_t previousTemperatureIndex;						// Which slot in previousTemperature we fill in next
 	float iAccumulator;										// The integral LocalHeater component
 	float lastPwm;											// The last PWM value we output, before scaling by kS
 	float averagePWM;										// The running average of the PWM, after scaling.
 	uint32_t timeSetHeating;								// When we turned on the heater
 	uint32_t lastSampleTime;								// Time when the temperature was last sampled by Spin()
+	float extrusionFeedForwardPwm;							// The PWM we added in the last sample to allow for the extrusion expected one dead time ahead
+	float mpcDisturbance;									// Estimated rate of temperature change not explained by the model, used by model predictive control
+	float mpcPwmSum;										// Sum of the PWM values output since we last filled a slot in mpcPwmHistory
+	uint8_t mpcPwmHistory[MpcHistoryLength];				// The average PWM values we output recently, scaled to 0..255
+	uint8_t mpcHistoryIndex;								// Which slot in mpcPwmHistory we fill in next
+	uint8_t mpcSamplesInSlot;								// How many samples are included in mpcPwmSum
+	uint8_t samplesSincePreviousTemperature;				// How many samples we have taken since we last recorded a previous temperature
 
 	uint16_t heatingFaultCount;								// Count of questionable heating behaviours
 
@@ -77,6 +96,8 @@ private:
 	HeaterMode mode;										// Current state of the heater
 	uint8_t badTemperatureCount;							// Count of sequential dud readings
 
+	HeaterTelemetry telemetry;								// What the control loop did in recent samples
+
 	static_assert(sizeof(previousTemperaturesGood) * 8 >= NumPreviousTemperatures, "too few bits in previousTemperaturesGood");
 };
 
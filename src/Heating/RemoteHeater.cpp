@@ -17,14 +17,9 @@
 #include <CanMessageFormats.h>
 #include <CanMessageBuffer.h>
 
-// Static variables used only during tuning
-uint32_t RemoteHeater::timeSetHeating;
-float RemoteHeater::currentCoolingRate;
-unsigned int RemoteHeater::tuningCyclesDone;
-bool RemoteHeater::newTuningResult = false;
-
 RemoteHeater::RemoteHeater(unsigned int num, CanAddress board) noexcept
-	: Heater(num), boardAddress(board), lastMode(HeaterMode::offline), averagePwm(0), tuningState(TuningState::notTuning), lastTemperature(0.0), whenLastStatusReceived(0)
+	: Heater(num), boardAddress(board), lastMode(HeaterMode::offline), averagePwm(0), tuningState(TuningState::notTuning), lastTemperature(0.0), whenLastStatusReceived(0),
+	  timeSetHeating(0), currentCoolingRate(0.0), tuningCyclesDone(0), newTuningResult(false)
 {
 }
 
@@ -40,26 +35,34 @@ RemoteHeater::~RemoteHeater() noexcept
 void RemoteHeater::Spin() noexcept
 {
 	const uint32_t now = millis();
+
+	// The expansion board controls this heater, so we can't limit its power. Just count the power it is using against the budget.
+	// We do this here rather than when we receive the status report so that only the heater task allocates power.
+	if (GetRatedPower() > 0.0)
+	{
+		(void)reprap.GetHeat().AllocateHeaterPower(GetHeaterNumber(), GetAveragePWM() * GetRatedPower(), HeaterPowerPriorityHolding);
+	}
+
 	switch (tuningState)
 	{
 	case TuningState::notTuning:
 		break;
 
 	case TuningState::stabilising:
-		if (tuningStartTemp.GetNumSamples() < 5000/HeatSampleIntervalMillis)
+		if (tuning->startTemp.GetNumSamples() < 5000/GetSampleIntervalMillis())
 		{
-			tuningStartTemp.Add(lastTemperature);						// take another reading until we have samples temperatures for 5 seconds
+			tuning->startTemp.Add(lastTemperature);						// take another reading until we have samples temperatures for 5 seconds
 		}
-		else if (tuningStartTemp.GetDeviation() <= 2.0)
+		else if (tuning->startTemp.GetDeviation() <= 2.0)
 		{
 			timeSetHeating = now;
-			ClearCounters();
+			tuning->ClearCounters();
 			timeSetHeating = millis();
 			String<StringLength100> reply;
 			if (SendTuningCommand(reply.GetRef(), true) == GCodeResult::ok)
 			{
 				tuningState = TuningState::heatingUp;
-				tuningPhase = 1;
+				tuning->phase = 1;
 				ReportTuningUpdate();
 			}
 			else
@@ -68,9 +71,9 @@ void RemoteHeater::Spin() noexcept
 				tuningState = TuningState::notTuning;
 			}
 		}
-		else if (now - tuningBeginTime >= 20000)						// allow up to 20 seconds for starting temperature to settle
+		else if (now - tuning->beginTime >= 20000)						// allow up to 20 seconds for starting temperature to settle
 		{
-			reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because starting temperature is not stable\n");
+			reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because starting temperature is not stable\n", GetHeaterNumber());
 			StopTuning();
 		}
 		break;
@@ -80,9 +83,9 @@ void RemoteHeater::Spin() noexcept
 			const bool isBedOrChamberHeater = reprap.GetHeat().IsBedOrChamberHeater(GetHeaterNumber());
 			const uint32_t heatingTime = now - timeSetHeating;
 			const float extraTimeAllowed = (isBedOrChamberHeater) ? 120.0 : 30.0;
-			if (heatingTime > (uint32_t)((GetModel().GetDeadTime() + extraTimeAllowed) * SecondsToMillis) && (lastTemperature - tuningStartTemp.GetMean()) < 3.0)
+			if (heatingTime > (uint32_t)((GetModel().GetDeadTime() + extraTimeAllowed) * SecondsToMillis) && (lastTemperature - tuning->startTemp.GetMean()) < 3.0)
 			{
-				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because temperature is not increasing\n");
+				reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because temperature is not increasing\n", GetHeaterNumber());
 				StopTuning();
 				break;
 			}
@@ -90,21 +93,21 @@ void RemoteHeater::Spin() noexcept
 			const uint32_t timeoutMinutes = (isBedOrChamberHeater) ? 30 : 7;
 			if (heatingTime >= timeoutMinutes * 60 * (uint32_t)SecondsToMillis)
 			{
-				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because target temperature was not reached\n");
+				reprap.GetPlatform().MessageF(GenericMessage, "Heater %u auto tune cancelled because target temperature was not reached\n", GetHeaterNumber());
 				StopTuning();
 				break;
 			}
 
-			if (lastTemperature >= tuningTargetTemp)							// if reached target
+			if (lastTemperature >= tuning->targetTemp)							// if reached target
 			{
 				// Move on to next phase
-				peakTemp = afterPeakTemp = lastTemperature;
-				lastOffTime = peakTime = afterPeakTime = now;
-				tuningVoltage.Clear();
-				idleCyclesDone = 0;
+				tuning->peakTemp = tuning->afterPeakTemp = lastTemperature;
+				tuning->lastOffTime = tuning->peakTime = tuning->afterPeakTime = now;
+				tuning->voltage.Clear();
+				tuning->idleCyclesDone = 0;
 				newTuningResult = false;
 				tuningState = TuningState::idleCycles;
-				tuningPhase = 2;
+				tuning->phase = 2;
 				ReportTuningUpdate();
 			}
 		}
@@ -114,17 +117,17 @@ void RemoteHeater::Spin() noexcept
 		if (newTuningResult)
 		{
 			// To allow for heat reservoirs, we do idle cycles until the cooling rate decreases by no more than a certain amount in a single cycle
-			if (idleCyclesDone == TuningHeaterMaxIdleCycles || (idleCyclesDone >= TuningHeaterMinIdleCycles && currentCoolingRate >= lastCoolingRate * HeaterSettledCoolingTimeRatio))
+			if (tuning->idleCyclesDone == TuningHeaterMaxIdleCycles || (tuning->idleCyclesDone >= TuningHeaterMinIdleCycles && currentCoolingRate >= tuning->lastCoolingRate * HeaterSettledCoolingTimeRatio))
 			{
-				tuningPhase = 3;
+				tuning->phase = 3;
 				tuningState = TuningState::cycling;
 				ReportTuningUpdate();
 			}
 			else
 			{
-				lastCoolingRate = currentCoolingRate;
-				ClearCounters();
-				++idleCyclesDone;
+				tuning->lastCoolingRate = currentCoolingRate;
+				tuning->ClearCounters();
+				++tuning->idleCyclesDone;
 			}
 			newTuningResult = false;
 		}
@@ -133,23 +136,23 @@ void RemoteHeater::Spin() noexcept
 	case TuningState::cycling:
 		if (newTuningResult)
 		{
-			if (coolingRate.GetNumSamples() >= MinTuningHeaterCycles)
+			if (tuning->coolingRate.GetNumSamples() >= MinTuningHeaterCycles)
 			{
-				const bool isConsistent = dLow.DeviationFractionWithin(0.2)
-										&& dHigh.DeviationFractionWithin(0.2)
-										&& heatingRate.DeviationFractionWithin(0.1)
-										&& coolingRate.DeviationFractionWithin(0.1);
-				if (isConsistent || coolingRate.GetNumSamples() == MaxTuningHeaterCycles)
+				const bool isConsistent = tuning->dLow.DeviationFractionWithin(0.2)
+										&& tuning->dHigh.DeviationFractionWithin(0.2)
+										&& tuning->heatingRate.DeviationFractionWithin(0.1)
+										&& tuning->coolingRate.DeviationFractionWithin(0.1);
+				if (isConsistent || tuning->coolingRate.GetNumSamples() == MaxTuningHeaterCycles)
 				{
 					if (!isConsistent)
 					{
 						reprap.GetPlatform().Message(WarningMessage, "heater behaviour was not consistent during tuning\n");
 					}
 
-					if (tuningPhase == 3)
+					if (tuning->phase == 3)
 					{
-						CalculateModel(fanOffParams);
-						if (tuningFans.IsEmpty())
+						CalculateModel(tuning->fanOffParams);
+						if (tuning->fans.IsEmpty())
 						{
 							SetAndReportModel(false);
 							StopTuning();
@@ -157,30 +160,30 @@ void RemoteHeater::Spin() noexcept
 						}
 						else
 						{
-							tuningPhase = 4;
-							ClearCounters();
+							tuning->phase = 4;
+							tuning->ClearCounters();
 #if TUNE_WITH_HALF_FAN
-							reprap.GetFansManager().SetFansValue(tuningFans,tuningFanPwm *  0.5);	// turn fans on at half PWM
+							reprap.GetFansManager().SetFansValue(tuning->fans,tuning->fanPwm *  0.5);	// turn fans on at half PWM
 #else
-							reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm);		// turn fans on at full PWM
+							reprap.GetFansManager().SetFansValue(tuning->fans, tuning->fanPwm);		// turn fans on at full PWM
 #endif
 							ReportTuningUpdate();
 						}
 					}
 #if TUNE_WITH_HALF_FAN
-					else if (tuningPhase == 4)
+					else if (tuning->phase == 4)
 					{
-						CalculateModel(fanOnParams);
-						tuningPhase = 5;
-						ClearCounters();
-						reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm);			// turn fans fully on
+						CalculateModel(tuning->fanOnParams);
+						tuning->phase = 5;
+						tuning->ClearCounters();
+						reprap.GetFansManager().SetFansValue(tuning->fans, tuning->fanPwm);			// turn fans fully on
 						ReportTuningUpdate();
 					}
 #endif
 					else
 					{
-						reprap.GetFansManager().SetFansValue(tuningFans, 0.0);					// turn fans off
-						CalculateModel(fanOnParams);
+						reprap.GetFansManager().SetFansValue(tuning->fans, 0.0);					// turn fans off
+						CalculateModel(tuning->fanOnParams);
 						SetAndReportModel(true);
 						StopTuning();
 						break;
@@ -286,7 +289,7 @@ float RemoteHeater::GetAccumulator() const noexcept
 	return 0.0;		// not supported
 }
 
-// Auto tune this heater. The caller has already checked that no other heater is being tuned and has set up tuningTargetTemp, tuningPwm, tuningFans, tuningHysteresis and tuningFanPwm.
+// Auto tune this heater. The caller has already checked that this heater can be tuned alongside any others being tuned and has set up the tuning parameters.
 GCodeResult RemoteHeater::StartAutoTune(const StringRef& reply, bool seenA, float ambientTemp) noexcept
 {
 	CanMessageBuffer * const buf = CanMessageBuffer::Allocate();
@@ -296,16 +299,16 @@ GCodeResult RemoteHeater::StartAutoTune(const StringRef& reply, bool seenA, floa
 		return GCodeResult::error;
 	}
 
-	reprap.GetFansManager().SetFansValue(tuningFans, 0.0);
+	reprap.GetFansManager().SetFansValue(tuning->fans, 0.0);
 
-	tuningStartTemp.Clear();
-	tuningBeginTime = millis();
+	tuning->startTemp.Clear();
+	tuning->beginTime = millis();
 	tuned = false;
 
 	if (seenA)
 	{
-		tuningStartTemp.Add(ambientTemp);
-		ClearCounters();
+		tuning->startTemp.Add(ambientTemp);
+		tuning->ClearCounters();
 		timeSetHeating = millis();
 		GCodeResult rslt = SendTuningCommand(reply, true);
 		if (rslt != GCodeResult::ok)
@@ -313,18 +316,25 @@ GCodeResult RemoteHeater::StartAutoTune(const StringRef& reply, bool seenA, floa
 			return rslt;
 		}
 		tuningState = TuningState::heatingUp;
-		tuningPhase = 1;
+		tuning->phase = 1;
 		ReportTuningUpdate();
 	}
 	else
 	{
 		tuningState = TuningState::stabilising;
-		tuningPhase = 0;
+		tuning->phase = 0;
 	}
 
 	return GCodeResult::ok;
 }
 
+// The expansion board runs the control loop, so we can't change how often it samples the temperature
+GCodeResult RemoteHeater::SetSampleInterval(uint32_t intervalMillis, const StringRef& reply) noexcept
+{
+	reply.copy("the sample interval of a heater on an expansion board can't be changed");
+	return GCodeResult::error;
+}
+
 void RemoteHeater::FeedForwardAdjustment(float fanPwmChange, float extrusionChange) noexcept
 {
 	constexpr const char* warnMsg = "Failed to make heater feedforward adjustment: %s\n";
@@ -468,13 +478,13 @@ void RemoteHeater::UpdateHeaterTuning(CanAddress src, const CanMessageHeaterTuni
 {
 	if (src == boardAddress && tuningState >= TuningState::idleCycles && !newTuningResult)
 	{
-		tOn.Add((float)msg.ton);
-		tOff.Add((float)msg.toff);
-		dHigh.Add((float)msg.dhigh);
-		dLow.Add((float)msg.dlow);
-		heatingRate.Add(msg.heatingRate);
-		coolingRate.Add(msg.coolingRate);
-		tuningVoltage.Add(msg.voltage);
+		tuning->tOn.Add((float)msg.ton);
+		tuning->tOff.Add((float)msg.toff);
+		tuning->dHigh.Add((float)msg.dhigh);
+		tuning->dLow.Add((float)msg.dlow);
+		tuning->heatingRate.Add(msg.heatingRate);
+		tuning->coolingRate.Add(msg.coolingRate);
+		tuning->voltage.Add(msg.voltage);
 		currentCoolingRate = msg.coolingRate;
 		tuningCyclesDone = msg.cyclesDone;
 		newTuningResult = true;
@@ -494,9 +504,9 @@ GCodeResult RemoteHeater::SendTuningCommand(const StringRef& reply, bool on) noe
 	auto msg = buf->SetupRequestMessage<CanMessageHeaterTuningCommand>(rid, CanInterface::GetCanAddress(), boardAddress);
 	msg->heaterNumber = GetHeaterNumber();
 	msg->on = on;
-	msg->highTemp = tuningTargetTemp;
-	msg->lowTemp = tuningTargetTemp - tuningHysteresis;
-	msg->pwm = tuningPwm;
+	msg->highTemp = tuning->targetTemp;
+	msg->lowTemp = tuning->targetTemp - tuning->hysteresis;
+	msg->pwm = tuning->pwm;
 	msg->peakTempDrop = TuningPeakTempDrop;
 	return CanInterface::SendRequestAndGetStandardReply(buf, rid, reply);
 }
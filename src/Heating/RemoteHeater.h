@@ -30,8 +30,10 @@ public:
 	float GetAccumulator() const noexcept override;							// Return the integral accumulator
 	void Suspend(bool sus) noexcept override;								// Suspend the heater to conserve power or while doing Z probing
 	void FeedForwardAdjustment(float fanPwmChange, float extrusionChange) noexcept override;
+	GCodeResult SetSampleInterval(uint32_t intervalMillis, const StringRef& reply) noexcept override;
 	void UpdateRemoteStatus(CanAddress src, const CanHeaterReport& report) noexcept override;
 	void UpdateHeaterTuning(CanAddress src, const CanMessageHeaterTuningReport& msg) noexcept override;
+	CanAddress GetBoardAddress() const noexcept override { return boardAddress; }
 
 protected:
 	void ResetHeater() noexcept override;
@@ -65,10 +67,10 @@ private:
 	uint32_t whenLastStatusReceived;
 
 	// Variables used only during tuning
-	static uint32_t timeSetHeating;											// When we turned on the heater at the start of auto tuning
-	static float currentCoolingRate;
-	static unsigned int tuningCyclesDone;
-	static bool newTuningResult;
+	uint32_t timeSetHeating;												// When we turned on the heater at the start of auto tuning
+	float currentCoolingRate;
+	unsigned int tuningCyclesDone;
+	bool newTuningResult;
 };
 
 #endif
@@ -73,7 +73,7 @@ GCodeResult CurrentLoopTemperatureSensor::Configure(GCodeBuffer& gb, const Strin
 	return GCodeResult::ok;
 }
 
-void CurrentLoopTemperatureSensor::Poll() noexcept
+void CurrentLoopTemperatureSensor::ReadSensor() noexcept
 {
 	float t;
 	const TemperatureError rslt = TryGetLinearAdcTemperature(t);
@@ -197,7 +197,7 @@ TemperatureError RtdSensor31865::TryInitRtd() const noexcept
 	return sts;
 }
 
-void RtdSensor31865::Poll() noexcept
+void RtdSensor31865::ReadSensor() noexcept
 {
 	static const uint8_t dataOut[4] = {0, 0x55, 0x55, 0x55};			// read registers 0 (control), 1 (MSB) and 2 (LSB)
 	uint32_t rawVal;
@@ -0,0 +1,194 @@
+/*
+ * SimulatedHeaterSensor.cpp
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#include "SimulatedHeaterSensor.h"
+
+#if SUPPORT_HEATER_SIMULATION
+
+#include <GCodes/GCodeBuffer/GCodeBuffer.h>
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
+#include <Fans/FansManager.h>
+#include <Heating/Heat.h>
+
+SimulatedHeaterSensor::SimulatedHeaterSensor(unsigned int sensorNum) noexcept
+	: TemperatureSensor(sensorNum, "Simulated heater"),
+	  heatingRate(2.0), coolingRateFanOff(0.01), coolingRateFanOn(0.01), deadTime(5.0), ambientTemperature(25.0), noise(0.0), fanNumber(-1), heaterNumber(-1)
+{
+	Reset();
+}
+
+// Configure the plant parameters. R, K and D have the same meaning as in M307. H is the heater that drives the simulation.
+GCodeResult SimulatedHeaterSensor::Configure(GCodeBuffer& gb, const StringRef& reply, bool& changed)
+{
+	// Read the new parameters into local variables, so that if any of them are bad we keep the old ones
+	float newHeatingRate = heatingRate;
+	float newCoolingRateFanOff = coolingRateFanOff;
+	float newCoolingRateFanOn = coolingRateFanOn;
+	float newDeadTime = deadTime;
+	float newAmbientTemperature = ambientTemperature;
+	float newNoise = noise;
+	int32_t newFanNumber = fanNumber;
+	int32_t newHeaterNumber = heaterNumber;
+
+	gb.TryGetFValue('R', newHeatingRate, changed);
+	if (gb.Seen('K'))
+	{
+		float coolingRates[2];
+		size_t numValues = 2;
+		gb.GetFloatArray(coolingRates, numValues, false);
+		newCoolingRateFanOff = coolingRates[0];
+		newCoolingRateFanOn = (numValues == 2) ? coolingRates[1] : coolingRates[0];
+		changed = true;
+	}
+	gb.TryGetFValue('D', newDeadTime, changed);
+	gb.TryGetFValue('T', newAmbientTemperature, changed);
+	gb.TryGetFValue('N', newNoise, changed);
+	gb.TryGetIValue('F', newFanNumber, changed);
+	gb.TryGetIValue('H', newHeaterNumber, changed);
+	TryConfigureSensorName(gb, changed);
+
+	if (changed)
+	{
+		if (   newHeatingRate <= 0.0 || newCoolingRateFanOff <= 0.0 || newCoolingRateFanOn < newCoolingRateFanOff || newDeadTime < 0.0 || newNoise < 0.0
+			|| newFanNumber >= (int32_t)MaxFans || newHeaterNumber >= (int32_t)MaxHeaters
+		   )
+		{
+			reply.copy("bad simulated heater parameters");
+			return GCodeResult::error;
+		}
+		heatingRate = newHeatingRate;
+		coolingRateFanOff = newCoolingRateFanOff;
+		coolingRateFanOn = newCoolingRateFanOn;
+		deadTime = newDeadTime;
+		ambientTemperature = newAmbientTemperature;
+		noise = newNoise;
+		fanNumber = max<int32_t>(newFanNumber, -1);
+		heaterNumber = max<int32_t>(newHeaterNumber, -1);
+		Reset();
+	}
+	else
+	{
+		CopyBasicDetails(reply);
+		reply.catf(", R%.3f K%.4f:%.4f D%.2f T%.1f N%.2f", (double)heatingRate, (double)coolingRateFanOff, (double)coolingRateFanOn, (double)deadTime, (double)ambientTemperature, (double)noise);
+		if (fanNumber >= 0)
+		{
+			reply.catf(" F%d", fanNumber);
+		}
+		if (heaterNumber >= 0)
+		{
+			reply.catf(" H%d", heaterNumber);
+		}
+		AppendResponseDetails(reply);
+	}
+	return GCodeResult::ok;
+}
+
+// Start again with the simulated heater at ambient temperature
+void SimulatedHeaterSensor::Reset() noexcept
+{
+	plantTemperature = ambientTemperature;
+	heaterPwm = 0.0;
+	slotMillis = max<uint32_t>(lrintf(deadTime * SecondsToMillis/DeadTimeSlots), MinSlotMillis);
+	numSlotsUsed = min<size_t>(lrintf(deadTime * SecondsToMillis/slotMillis), DeadTimeSlots);
+	lastSlotTime = lastPollTime = millis();
+	pwmHistoryIndex = 0;
+	memset(pwmHistory, 0, sizeof(pwmHistory));
+	targetTemperature = startTemperature = overshoot = 0.0;
+	whenTargetChanged = whenLastOutsideBand = lastPollTime;
+}
+
+// Advance the simulation to the current time and return the simulated reading
+void SimulatedHeaterSensor::Poll() noexcept
+{
+	const uint32_t now = millis();
+
+	// Find out what the heater is doing. If its target has changed then start measuring a new step response.
+	if (heaterNumber >= 0)
+	{
+		float newTarget;
+		reprap.GetHeat().GetSimulatedHeaterOutput(heaterNumber, heaterPwm, newTarget);
+		heaterPwm = constrain<float>(heaterPwm, 0.0, 1.0);
+		if (fabsf(newTarget - targetTemperature) > SettledBand)
+		{
+			startTemperature = plantTemperature;
+			overshoot = 0.0;
+			whenTargetChanged = whenLastOutsideBand = now;
+		}
+		targetTemperature = newTarget;
+	}
+
+	// Record the PWM in the history once per slot. The oldest slot holds the PWM that the heater output one dead time ago.
+	float delayedPwm = heaterPwm;
+	if (numSlotsUsed != 0)
+	{
+		while (now - lastSlotTime >= slotMillis)
+		{
+			pwmHistory[pwmHistoryIndex] = (uint8_t)lrintf(heaterPwm * 255.0);
+			pwmHistoryIndex = (pwmHistoryIndex + 1) % numSlotsUsed;
+			lastSlotTime += slotMillis;
+		}
+		delayedPwm = (float)pwmHistory[pwmHistoryIndex] * (1.0/255.0);
+	}
+
+	// Use the exact solution of the first order model over the interval, assuming the PWM and fan speed were constant during it
+	float fanPwm = 0.0;
+	if (fanNumber >= 0)
+	{
+		fanPwm = max<float>(reprap.GetFansManager().GetFanValue(fanNumber), 0.0);
+	}
+	const float coolingRate = coolingRateFanOff + (coolingRateFanOn - coolingRateFanOff) * fanPwm;
+	const float steadyStateTemperature = ambientTemperature + (heatingRate * delayedPwm)/coolingRate;
+	const float interval = (float)(now - lastPollTime) * MillisToSeconds;
+	plantTemperature = steadyStateTemperature + (plantTemperature - steadyStateTemperature) * expf(-coolingRate * interval);
+	lastPollTime = now;
+
+	// Track the step response to the current target
+	if (targetTemperature > 0.0)
+	{
+		const float excess = (targetTemperature >= startTemperature) ? plantTemperature - targetTemperature : targetTemperature - plantTemperature;
+		if (excess > overshoot)
+		{
+			overshoot = excess;
+		}
+		if (fabsf(plantTemperature - targetTemperature) > SettledBand)
+		{
+			whenLastOutsideBand = now;
+		}
+	}
+
+	const float reading = (noise > 0.0) ? plantTemperature + noise * (float)(random(2001) - 1000) * 0.001 : plantTemperature;
+	SetResult(reading, TemperatureError::success);
+}
+
+void SimulatedHeaterSensor::AppendResponseDetails(const StringRef& reply) const noexcept
+{
+	if (targetTemperature > 0.0)
+	{
+		reply.catf(", target %.1fC, overshoot %.1fC", (double)targetTemperature, (double)max<float>(overshoot, 0.0));
+		if (millis() - whenLastOutsideBand >= (uint32_t)lrintf(max<float>(deadTime, 1.0) * SecondsToMillis))
+		{
+			reply.catf(", settled in %.1fs", (double)((float)(whenLastOutsideBand - whenTargetChanged) * MillisToSeconds));
+		}
+		else
+		{
+			reply.cat(", not settled");
+		}
+	}
+}
+
+void SimulatedHeaterSensor::Diagnostics(MessageType mtype) noexcept
+{
+	String<StringLength100> reply;
+	reply.printf("Sensor %u simulated heater at %.1fC", GetSensorNumber(), (double)plantTemperature);
+	AppendResponseDetails(reply.GetRef());
+	reply.cat('\n');
+	reprap.GetPlatform().Message(mtype, reply.c_str());
+}
+
+#endif
+
+// End
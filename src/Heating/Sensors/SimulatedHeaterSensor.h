@@ -0,0 +1,68 @@
+/*
+ * SimulatedHeaterSensor.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ *  Temperature sensor that simulates the thermal response of a heater, so that heater tuning and temperature control can be exercised without real hardware
+ */
+
+#ifndef SRC_HEATING_SENSORS_SIMULATEDHEATERSENSOR_H_
+#define SRC_HEATING_SENSORS_SIMULATEDHEATERSENSOR_H_
+
+#include "TemperatureSensor.h"
+
+#if SUPPORT_HEATER_SIMULATION
+
+// This class simulates a first order plus dead time heater with optional fan cooling and measurement noise.
+// The sensor reads the PWM and target temperature of the local heater given by the H parameter each time it is polled.
+class SimulatedHeaterSensor : public TemperatureSensor
+{
+public:
+	SimulatedHeaterSensor(unsigned int sensorNum) noexcept;
+
+	GCodeResult Configure(GCodeBuffer& gb, const StringRef& reply, bool& changed) override THROWS(GCodeException);
+	void Poll() noexcept override;
+	void Diagnostics(MessageType mtype) noexcept override;
+	const char *GetShortSensorType() const noexcept override { return TypeName; }
+
+	static constexpr const char *TypeName = "simulatedheater";
+
+private:
+	static constexpr size_t DeadTimeSlots = 64;				// number of slots in the PWM history used to simulate the dead time
+	static constexpr uint32_t MinSlotMillis = 10;
+	static constexpr float SettledBand = TEMPERATURE_CLOSE_ENOUGH;
+
+	void Reset() noexcept;
+	void AppendResponseDetails(const StringRef& reply) const noexcept;
+
+	// Plant parameters, in the same units as M307
+	float heatingRate;										// temperature rise rate in C/sec at full power with the heater at ambient temperature
+	float coolingRateFanOff;								// cooling rate in 1/sec with the fan off
+	float coolingRateFanOn;									// cooling rate in 1/sec with the fan at full speed
+	float deadTime;											// dead time in seconds
+	float ambientTemperature;
+	float noise;											// peak measurement noise in C
+	int fanNumber;											// fan that cools the heater, or -1 if none
+	int heaterNumber;										// the heater whose output drives the simulation, or -1 if none
+
+	// Plant state
+	float plantTemperature;									// simulated temperature without noise
+	float heaterPwm;										// the PWM that the heater most recently output
+	uint32_t slotMillis;									// length of each slot in the PWM history
+	size_t numSlotsUsed;									// number of slots in the PWM history that make up the dead time
+	uint32_t lastSlotTime;
+	uint32_t lastPollTime;
+	size_t pwmHistoryIndex;
+	uint8_t pwmHistory[DeadTimeSlots];						// PWM that the heater output in past slots, scaled to 0..255
+
+	// Step response measurements
+	float targetTemperature;								// the heater target temperature, or 0 if the heater isn't using one
+	float startTemperature;									// the temperature when the target was last changed
+	float overshoot;										// the furthest the temperature went past the target
+	uint32_t whenTargetChanged;
+	uint32_t whenLastOutsideBand;							// the last time the temperature was further than SettledBand from the target
+};
+
+#endif
+
+#endif /* SRC_HEATING_SENSORS_SIMULATEDHEATERSENSOR_H_ */
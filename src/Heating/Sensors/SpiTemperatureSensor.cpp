@@ -7,7 +7,14 @@
 
 #include "SpiTemperatureSensor.h"
 #include <Platform/Tasks.h>
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
 #include <Hardware/SharedSpi/SharedSpiDevice.h>
+#include <Heating/Heat.h>
+#include <Movement/StepTimer.h>
+
+SpiTemperatureSensor * volatile SpiTemperatureSensor::queueHead = nullptr;
+SpiTemperatureSensor * volatile SpiTemperatureSensor::queueTail = nullptr;
 
 SpiTemperatureSensor::SpiTemperatureSensor(unsigned int sensorNum, const char *name, SpiMode spiMode, uint32_t clockFrequency) noexcept
 	: SensorWithPort(sensorNum, name), 
@@ -16,12 +23,18 @@ SpiTemperatureSensor::SpiTemperatureSensor(unsigned int sensorNum, const char *n
 #else
 	device(SharedSpiDevice::GetMainSharedSpiDevice(),
 #endif
-	 clockFrequency, spiMode, NoPin, false)
+	 clockFrequency, spiMode, NoPin, false),
+	  nextQueued(nullptr), whenQueued(0), lastReadLatency(0), maxReadLatency(0), readPending(false)
 {
 	lastTemperature = 0.0;
 	lastResult = TemperatureError::notInitialised;
 }
 
+SpiTemperatureSensor::~SpiTemperatureSensor() noexcept
+{
+	RemoveFromQueue();
+}
+
 bool SpiTemperatureSensor::ConfigurePort(GCodeBuffer& gb, const StringRef& reply, bool& seen)
 {
 	const bool ret = SensorWithPort::ConfigurePort(gb, reply, PinAccess::write1, seen);
@@ -43,6 +56,96 @@ bool SpiTemperatureSensor::ConfigurePort(const CanMessageGenericParser& parser,
 void SpiTemperatureSensor::InitSpi() noexcept
 {
 	lastReadingTime = millis();
+	Heat::EnsureSpiSensorsTask();
+}
+
+// Request a reading. This is called by the heater task, which must not wait for the SPI bus, so the reading is queued and taken by the SPI sensors task.
+// The heater task wakes the SPI sensors task after it has polled all the sensors that are due, so that they are read in a single batch.
+void SpiTemperatureSensor::Poll() noexcept
+{
+	TaskCriticalSectionLocker lock;
+
+	if (!readPending)
+	{
+		readPending = true;
+		whenQueued = StepTimer::GetTimerTicks();
+		nextQueued = nullptr;
+		if (queueHead == nullptr)
+		{
+			queueHead = this;
+		}
+		else
+		{
+			queueTail->nextQueued = this;
+		}
+		queueTail = this;
+	}
+}
+
+// Remove the next sensor from the queue of readings to be taken. Called by the SPI sensors task with the sensors lock held.
+/*static*/ SpiTemperatureSensor *SpiTemperatureSensor::DequeueRead() noexcept
+{
+	TaskCriticalSectionLocker lock;
+
+	SpiTemperatureSensor * const s = queueHead;
+	if (s != nullptr)
+	{
+		queueHead = s->nextQueued;
+		if (queueHead == nullptr)
+		{
+			queueTail = nullptr;
+		}
+		s->nextQueued = nullptr;
+	}
+	return s;
+}
+
+// Remove this sensor from the queue if it is in it. Called when the sensor is deleted.
+void SpiTemperatureSensor::RemoveFromQueue() noexcept
+{
+	TaskCriticalSectionLocker lock;
+
+	SpiTemperatureSensor *prev = nullptr;
+	for (SpiTemperatureSensor *s = queueHead; s != nullptr; s = s->nextQueued)
+	{
+		if (s == this)
+		{
+			if (prev == nullptr)
+			{
+				queueHead = nextQueued;
+			}
+			else
+			{
+				prev->nextQueued = nextQueued;
+			}
+			if (queueTail == this)
+			{
+				queueTail = prev;
+			}
+			break;
+		}
+		prev = s;
+	}
+	readPending = false;
+}
+
+// Take a reading that was requested by Poll and record how long the request took to complete
+void SpiTemperatureSensor::DoQueuedRead() noexcept
+{
+	ReadSensor();
+	const uint32_t latency = ((uint64_t)(StepTimer::GetTimerTicks() - whenQueued) * 1000000u)/StepTimer::GetTickRate();
+	lastReadLatency = latency;
+	if (latency > maxReadLatency)
+	{
+		maxReadLatency = latency;
+	}
+	readPending = false;
+}
+
+void SpiTemperatureSensor::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Sensor %u SPI read latency %" PRIu32 "us, max %" PRIu32 "us\n", GetSensorNumber(), lastReadLatency, maxReadLatency);
+	maxReadLatency = 0;
 }
 
 // Send and receive 1 to 8 bytes of data and return the result as a single 32-bit word
@@ -13,7 +13,24 @@
 
 class SpiTemperatureSensor : public SensorWithPort
 {
+public:
+	~SpiTemperatureSensor() noexcept override;
+
+	void Poll() noexcept override final;						// queue a reading, which the SPI sensors task will take
+	bool IsReadPending() const noexcept override { return readPending; }
+	uint32_t GetMinimumPollInterval() const noexcept override { return MinimumPollInterval; }
+	void Diagnostics(MessageType mtype) noexcept override;
+
+	void DoQueuedRead() noexcept;								// called by the SPI sensors task
+
+	static SpiTemperatureSensor *DequeueRead() noexcept;
+	static bool AnyReadsQueued() noexcept { return queueHead != nullptr; }
+
 protected:
+	static constexpr uint32_t MinimumPollInterval = 100;		// the converters we support need about this long to complete a conversion
+
+	virtual void ReadSensor() noexcept = 0;						// do the SPI transactions to take a reading and set the result
+
 	SpiTemperatureSensor(unsigned int sensorNum, const char *name, SpiMode spiMode, uint32_t clockFrequency) noexcept;
 
 	bool ConfigurePort(GCodeBuffer& gb, const StringRef& reply, bool& seen) THROWS(GCodeException);
@@ -30,6 +47,18 @@ protected:
 	uint32_t lastReadingTime;
 	float lastTemperature;
 	TemperatureError lastResult;
+
+private:
+	void RemoveFromQueue() noexcept;
+
+	static SpiTemperatureSensor * volatile queueHead;			// readings are taken in the order that they were requested
+	static SpiTemperatureSensor * volatile queueTail;
+
+	SpiTemperatureSensor * volatile nextQueued;
+	uint32_t whenQueued;										// step clock when the reading was requested
+	uint32_t lastReadLatency;									// microseconds from the request to the end of the last reading
+	uint32_t maxReadLatency;									// maximum of the above since the last diagnostics report
+	volatile bool readPending;									// a reading has been requested and not completed yet
 };
 
 #endif /* SRC_HEATING_SPITEMPERATURESENSOR_H_ */
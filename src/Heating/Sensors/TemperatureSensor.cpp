@@ -21,6 +21,10 @@
 # include "DhtSensor.h"
 #endif
 
+#if SUPPORT_HEATER_SIMULATION
+# include "SimulatedHeaterSensor.h"
+#endif
+
 #if HAS_SMART_DRIVERS
 # include "TmcDriverTemperatureSensor.h"
 #endif
@@ -242,6 +246,12 @@ TemperatureSensor *TemperatureSensor::Create(unsigned int sensorNum, const char
 		ts = new DhtHumiditySensor(sensorNum);
 	}
 #endif
+#if SUPPORT_HEATER_SIMULATION
+	else if (ReducedStringEquals(typeName, SimulatedHeaterSensor::TypeName))
+	{
+		ts = new SimulatedHeaterSensor(sensorNum);
+	}
+#endif
 #if HAS_CPU_TEMP_SENSOR
 	else if (ReducedStringEquals(typeName, CpuTemperatureSensor::TypeName))
 	{
@@ -91,7 +91,13 @@ public:
 
 	// Try to get a temperature reading
 	virtual void Poll() noexcept = 0;
-	virtual bool PollInTask() noexcept { return false; };		// Classes implementing this method need to also call Heat::EnsureSensorsTask() after successful configuration
+	// Classes implementing this method need to also call Heat::EnsureSensorsTask() after successful configuration
+	virtual bool PollInTask() noexcept { return false; };
+	virtual bool IsReadPending() const noexcept { return false; }			// Return true if a reading requested by Poll has not completed yet
+	virtual uint32_t GetMinimumPollInterval() const noexcept { return 0; }	// Get the minimum interval in milliseconds between calls to Poll
+
+	// Report diagnostic information, if any
+	virtual void Diagnostics(MessageType mtype) noexcept { }
 
 	static TemperatureError GetPT100Temperature(float& t, uint16_t ohmsx100) noexcept;		// shared function used by two derived classes and the ATE
 
@@ -211,7 +211,7 @@ TemperatureError ThermocoupleSensor31856::TryInitThermocouple() const noexcept
 	return sts;
 }
 
-void ThermocoupleSensor31856::Poll() noexcept
+void ThermocoupleSensor31856::ReadSensor() noexcept
 {
 	static const uint8_t dataOut[5] = {0x0C, 0x55, 0x55, 0x55, 0x55};	// read registers LTCB0, LTCB1, LTCB2, Fault status
 	uint32_t rawVal;
@@ -63,7 +63,7 @@ GCodeResult ThermocoupleSensor6675::Configure(GCodeBuffer& gb, const StringRef&
 	return GCodeResult::ok;
 }
 
-void ThermocoupleSensor6675::Poll() noexcept
+void ThermocoupleSensor6675::ReadSensor() noexcept
 {
 	uint32_t rawVal;
 	TemperatureError sts = DoSpiTransaction(nullptr, 2, rawVal);
@@ -15,7 +15,7 @@ class ThermocoupleSensor6675 : public SpiTemperatureSensor
 public:
 	ThermocoupleSensor6675(unsigned int sensorNum) noexcept;
 	GCodeResult Configure(GCodeBuffer& gb, const StringRef& reply, bool& changed) override THROWS(GCodeException);
-	void Poll() noexcept override;
+	void ReadSensor() noexcept override;
 	const char *GetShortSensorType() const noexcept override { return TypeName; }
 
 	static constexpr const char *TypeName = "thermocouplemax6675";
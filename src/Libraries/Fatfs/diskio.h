@@ -9,6 +9,9 @@
 unsigned int DiskioGetAndClearMaxRetryCount() noexcept;
 float DiskioGetAndClearLongestReadTime() noexcept;
 float DiskioGetAndClearLongestWriteTime() noexcept;
+#if SD_READ_CACHE_LINES
+void DiskioGetAndClearCacheStats(uint32_t& hits, uint32_t& misses) noexcept;
+#endif
 
 extern "C" {
 
@@ -67,6 +67,7 @@ uint32_t HeaderCRCErrors, DataCRCErrors;
 #include <Platform/RepRap.h>
 #include <Cache.h>
 #include <RTOSIface/RTOSIface.h>
+#include <Movement/StepTimer.h>
 
 #include <General/IP4String.h>
 static TaskHandle linuxTaskHandle = nullptr;
@@ -405,6 +406,7 @@ alignas(4) __nocache char DataTransfer::txBuffer[LinuxTransferBufferSize];
 #endif
 
 DataTransfer::DataTransfer() noexcept : state(SpiState::ExchangingData), lastTransferTime(0), lastTransferNumber(0), failedTransfers(0), checksumErrors(0),
+	numTransfers(0), processingStartedAt(0), maxProcessingTicks(0), lastDiagnosticsTime(0),
 #if SAME5x
 	rxBuffer(nullptr), txBuffer(nullptr),
 #endif
@@ -504,6 +506,15 @@ void DataTransfer::Diagnostics(MessageType mtype) noexcept
 	reprap.GetPlatform().MessageF(mtype, "Last transfer: %" PRIu32 "ms ago\n", millis() - lastTransferTime);
 	reprap.GetPlatform().MessageF(mtype, "RX/TX seq numbers: %d/%d\n", (int)rxHeader.sequenceNumber, (int)txHeader.sequenceNumber);
 	reprap.GetPlatform().MessageF(mtype, "SPI underruns %u, overruns %u\n", spiTxUnderruns, spiRxOverruns);
+
+	// Report the transfer rate and the longest time the SBC had to wait for us to start the next transfer
+	const uint32_t now = millis();
+	const uint32_t interval = now - lastDiagnosticsTime;
+	reprap.GetPlatform().MessageF(mtype, "Transfers per second: %.1f, max wait: %.2fms\n",
+									(interval == 0) ? 0.0 : (double)numTransfers * 1000.0/interval, (double)maxProcessingTicks * 1000.0/StepTimer::GetTickRate());
+	numTransfers = 0;
+	maxProcessingTicks = 0;
+	lastDiagnosticsTime = now;
 #if LPC17xx || STM32F4
 	reprap.GetPlatform().MessageF(mtype, "CRC errors header %u, data %u\n", (unsigned)HeaderCRCErrors, (unsigned)DataCRCErrors);
 #endif
@@ -549,6 +560,42 @@ void DataTransfer::ReadGetObjectModel(size_t packetLength, const StringRef &key,
 	flags.copy(data, header->flagsLength);
 }
 
+// Read a batched object model request. Return a pointer to the first key entry.
+const char *DataTransfer::ReadGetObjectModelBatch(size_t packetLength, const StringRef &flags, size_t& numKeys, const char *&dataEnd) noexcept
+{
+	// Read header
+	const GetObjectModelBatchHeader *header = ReadDataHeader<GetObjectModelBatchHeader>();
+	const size_t dataLength = packetLength - sizeof(GetObjectModelBatchHeader);
+	const char *data = ReadData(dataLength);
+	dataEnd = data + dataLength;
+	numKeys = header->numKeys;
+
+	// Read flags
+	flags.copy(data, header->flagsLength);
+	return data + AddPadding(header->flagsLength);
+}
+
+// Read the next key of a batched object model request and advance to the entry after it. Return false if the entry is malformed.
+bool DataTransfer::ReadObjectModelBatchEntry(const char *&entry, const char *dataEnd, const StringRef &key, uint32_t& lastSeq) const noexcept
+{
+	if (entry + sizeof(GetObjectModelBatchEntry) > dataEnd)
+	{
+		return false;
+	}
+
+	const GetObjectModelBatchEntry *header = reinterpret_cast<const GetObjectModelBatchEntry*>(entry);
+	const char * const keyData = entry + sizeof(GetObjectModelBatchEntry);
+	if (keyData + header->keyLength > dataEnd)
+	{
+		return false;
+	}
+
+	lastSeq = header->lastSeq;
+	key.copy(keyData, header->keyLength);
+	entry = keyData + AddPadding(header->keyLength);
+	return true;
+}
+
 void DataTransfer::ReadPrintStartedInfo(size_t packetLength, const StringRef& filename, GCodeFileInfo& info) noexcept
 {
 	// Read header
@@ -759,6 +806,13 @@ void DataTransfer::ResetTransfer(bool ownRequest) noexcept
 	}
 }
 
+// Record that a transfer has completed and the SBC is now waiting for us to process it
+void DataTransfer::TransferCompleted() noexcept
+{
+	processingStartedAt = StepTimer::GetTimerTicks();
+	++numTransfers;
+}
+
 bool DataTransfer::IsReady() noexcept
 {
 	if (dataReceived)
@@ -856,6 +910,7 @@ bool DataTransfer::IsReady() noexcept
 					rxPointer = txPointer = 0;
 					packetId = 0;
 					state = SpiState::ProcessingData;
+					TransferCompleted();
 					return true;
 				}
 			}
@@ -919,6 +974,7 @@ bool DataTransfer::IsReady() noexcept
 				rxPointer = txPointer = 0;
 				packetId = 0;
 				state = SpiState::ProcessingData;
+				TransferCompleted();
 				return true;
 			}
 
@@ -985,6 +1041,14 @@ bool DataTransfer::IsReady() noexcept
 
 void DataTransfer::StartNextTransfer() noexcept
 {
+	if (state == SpiState::ProcessingData)
+	{
+		const uint32_t processingTicks = StepTimer::GetTimerTicks() - processingStartedAt;
+		if (processingTicks > maxProcessingTicks)
+		{
+			maxProcessingTicks = processingTicks;
+		}
+	}
 	lastTransferNumber = rxHeader.sequenceNumber;
 
 	// Reset RX transfer header
@@ -42,6 +42,8 @@ public:
 	const PacketHeader *ReadPacket() noexcept;												// Attempt to read the next packet header or return null. Advances the read pointer to the next packet or the packet's data
 	const char *ReadData(size_t packetLength) noexcept;										// Read the packet data and advance to the next packet (if any)
 	void ReadGetObjectModel(size_t packetLength, const StringRef &key, const StringRef &flags) noexcept;		// Read an object model request
+	const char *ReadGetObjectModelBatch(size_t packetLength, const StringRef &flags, size_t& numKeys, const char *&dataEnd) noexcept;	// Read a batched object model request
+	bool ReadObjectModelBatchEntry(const char *&entry, const char *dataEnd, const StringRef &key, uint32_t& lastSeq) const noexcept;	// Read the next key of a batched object model request
 	void ReadPrintStartedInfo(size_t packetLength, const StringRef& filename, GCodeFileInfo &info) noexcept;	// Read info about the started file print
 	PrintStoppedReason ReadPrintStoppedInfo() noexcept;										// Read info about why the print has been stopped
 	GCodeChannel ReadMacroCompleteInfo(bool &error) noexcept;								// Read info about a completed macro file
@@ -92,6 +94,12 @@ private:
 	uint16_t lastTransferNumber;
 	unsigned int failedTransfers, checksumErrors;
 
+	// Throughput statistics, reset when the diagnostics are reported
+	uint32_t numTransfers;							// number of complete transfers since the last diagnostics report
+	uint32_t processingStartedAt;					// step clock ticks when the last transfer completed
+	uint32_t maxProcessingTicks;					// longest time between a transfer completing and the next one being started
+	uint32_t lastDiagnosticsTime;
+
 	// Transfer buffers
 
 #if SAME70
@@ -125,6 +133,7 @@ private:
 	void ExchangeResponse(uint32_t response) noexcept;
 	void ExchangeData() noexcept;
 	void ResetTransfer(bool ownRequest) noexcept;
+	void TransferCompleted() noexcept;
 	uint32_t CalcCRC32(const char *buffer, size_t length) const noexcept;
 
 	template<typename T> const T *ReadDataHeader() noexcept;
@@ -45,12 +45,15 @@ constexpr size_t SBCTaskStackWords = 820;
 
 static TASKMEM Task<SBCTaskStackWords> *sbcTask;
 
+// Stop adding keys to the response to a batched object model request once it reaches this size, so that it is likely to fit in one transfer
+constexpr size_t MaxObjectModelBatchResponseLength = LinuxTransferBufferSize/2;
+
 extern "C" [[noreturn]] void SBCTaskStart(void * pvParameters) noexcept
 {
 	reprap.GetLinuxInterface().TaskLoop();
 }
 
-LinuxInterface::LinuxInterface() noexcept : isConnected(false), numDisconnects(0), numTimeouts(0),
+LinuxInterface::LinuxInterface() noexcept : isConnected(false), numDisconnects(0), numTimeouts(0), numCodesReceived(0), lastDiagnosticsTime(0),
 	reportPause(false), reportPauseWritten(false), printStarted(false), printStopped(false),
 	codeBuffer(nullptr), rxPointer(0), txPointer(0), txEnd(0), sendBufferUpdate(true),
 	iapWritePointer(IAP_IMAGE_START), waitingForFileChunk(false)
@@ -70,6 +73,12 @@ void LinuxInterface::Init() noexcept
 	pinMode(EspEnablePin, OUTPUT_LOW);
 #endif
 
+	for (size_t i = 0; i < NumGCodeChannels; ++i)
+	{
+		codeStarved[i] = false;
+		codeStarvationCount[i] = 0;
+	}
+
 	transfer.Init();
 	sbcTask = new Task<SBCTaskStackWords>;
 	sbcTask->Create(SBCTaskStart, "SBC", nullptr, TaskPriority::SbcPriority);
@@ -118,7 +127,7 @@ void LinuxInterface::Init() noexcept
 					break;
 				}
 
-				if (packet->request >= (uint16_t)LinuxRequest::InvalidRequest)
+				if (packet->request == (uint16_t)LinuxRequest::InvalidRequest || packet->request > (uint16_t)LinuxRequest::LastRequest)
 				{
 					REPORT_INTERNAL_ERROR;
 					break;
@@ -205,6 +214,7 @@ void LinuxInterface::Init() noexcept
 					const uint32_t *src = reinterpret_cast<const uint32_t *>(code);
 					memcpyu32(dst, src, packet->length / sizeof(uint32_t));
 					txPointer += bufferedCodeSize;
+					++numCodesReceived;
 					break;
 				}
 
@@ -249,6 +259,71 @@ void LinuxInterface::Init() noexcept
 					break;
 				}
 
+				// Get several parts of the object model in one response
+				case LinuxRequest::GetObjectModelBatch:
+				{
+					String<StringLength20> flags;
+					size_t numKeys;
+					const char *dataEnd;
+					const char *entry = transfer.ReadGetObjectModelBatch(packet->length, flags.GetRef(), numKeys, dataEnd);
+
+					OutputBuffer *outBuf;
+					if (!OutputBuffer::Allocate(outBuf))
+					{
+						packetAcknowledged = false;
+						break;
+					}
+
+					try
+					{
+						String<StringLength100> key;
+						uint32_t lastSeq;
+						outBuf->cat('[');
+						for (size_t i = 0; i < numKeys && transfer.ReadObjectModelBatchEntry(entry, dataEnd, key.GetRef(), lastSeq); ++i)
+						{
+							if (i != 0)
+							{
+								// Leave out the remaining keys if the response is getting too big to fit in a transfer. The SBC will ask for them again.
+								if (outBuf->Length() >= MaxObjectModelBatchResponseLength)
+								{
+									break;
+								}
+								outBuf->cat(',');
+							}
+							reprap.AppendModelResponse(outBuf, key.c_str(), flags.c_str(), lastSeq);
+						}
+						outBuf->cat("]\n");
+
+						if (outBuf->HadOverflow() || !transfer.WriteObjectModel(outBuf))
+						{
+							// Failed to write the whole response, try again later
+							packetAcknowledged = false;
+							OutputBuffer::ReleaseAll(outBuf);
+						}
+					}
+					catch (const GCodeException& e)
+					{
+						// Get the error message and send it back to DSF instead of the partial response
+						OutputBuffer::ReleaseAll(outBuf);
+						if (OutputBuffer::Allocate(outBuf))
+						{
+							String<StringLength100> errorMessage;
+							e.GetMessage(errorMessage.GetRef(), nullptr);
+							outBuf->cat(errorMessage.c_str());
+							if (!transfer.WriteObjectModel(outBuf))
+							{
+								OutputBuffer::ReleaseAll(outBuf);
+								packetAcknowledged = false;
+							}
+						}
+						else
+						{
+							packetAcknowledged = false;
+						}
+					}
+					break;
+				}
+
 				// Set value in the object model
 				case LinuxRequest::SetObjectModel:
 				{
@@ -843,8 +918,11 @@ void LinuxInterface::Init() noexcept
 						}
 					}
 
-					// Deal with other requests unless we are still waiting in a semaphore
-					if (!gb->IsWaitingForMacro())
+					// Deal with other requests unless we are still waiting in a semaphore.
+					// Don't take the mutex unless there is something to send, because the main task may hold it and we would delay the next transfer.
+					// The flags are checked again below once we have the mutex.
+					if (!gb->IsWaitingForMacro() &&
+						(gb->IsAbortRequested() || gb->IsMessagePromptPending() || gb->IsMessageAcknowledged() || gb->IsMacroRequestPending() || gb->IsSendRequested()))
 					{
 						MutexLocker gbLock(gb->mutex, 10);
 						if (gbLock)
@@ -1003,6 +1081,22 @@ void LinuxInterface::Diagnostics(MessageType mtype) noexcept
 	transfer.Diagnostics(mtype);
 	reprap.GetPlatform().MessageF(mtype, "Disconnects: %" PRIu32 ", timeouts: %" PRIu32 ", IAP RAM available 0x%05" PRIx32 "\n", numDisconnects, numTimeouts, iapRamAvailable);
 	reprap.GetPlatform().MessageF(mtype, "Buffer RX/TX: %d/%d-%d\n", (int)rxPointer, (int)txPointer, (int)txEnd);
+
+	const uint32_t now = millis();
+	const uint32_t interval = now - lastDiagnosticsTime;
+	reprap.GetPlatform().MessageF(mtype, "Codes per second: %.1f\n", (interval == 0) ? 0.0 : (double)numCodesReceived * 1000.0/interval);
+	numCodesReceived = 0;
+	lastDiagnosticsTime = now;
+
+	String<StringLength100> starvation;
+	for (size_t i = 0; i < NumGCodeChannels; ++i)
+	{
+		if (codeStarvationCount[i] != 0)
+		{
+			starvation.catf(" %s %" PRIu32, GCodeChannel(i).ToString(), codeStarvationCount[i]);
+		}
+	}
+	reprap.GetPlatform().MessageF(mtype, "Code starvation:%s\n", (starvation.IsEmpty()) ? " none" : starvation.c_str());
 #ifdef TRACK_FILE_CODES
 	reprap.GetPlatform().MessageF(mtype, "File codes read/handled: %d/%d, file macros open/closing: %d %d\n", (int)fileCodesRead, (int)fileCodesHandled, (int)fileMacrosRunning, (int)fileMacrosClosing);
 #endif
@@ -1108,11 +1202,22 @@ bool LinuxInterface::FillBuffer(GCodeBuffer &gb) noexcept
 		}
 	}
 
+	// Keep track of how often a channel that is executing a file on the SBC runs out of codes.
+	// Count each period of starvation only once, and make sure the SBC learns about the free buffer space in the next transfer.
+	const size_t channel = gb.GetChannel().ToBaseType();
 	if (gotCommand)
 	{
+		codeStarved[channel] = false;
 		gb.DecodeCommand();
 		return true;
 	}
+
+	if (!codeStarved[channel] && gb.IsDoingFile())
+	{
+		codeStarved[channel] = true;
+		++codeStarvationCount[channel];
+		sendBufferUpdate = true;
+	}
 	return false;
 }
 
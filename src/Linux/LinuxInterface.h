@@ -58,6 +58,8 @@ private:
 	DataTransfer transfer;
 	bool isConnected;
 	uint32_t numDisconnects, numTimeouts;
+	uint32_t numCodesReceived;											// codes received since the last diagnostics report
+	uint32_t lastDiagnosticsTime;
 
 	GCodeFileInfo fileInfo;
 	FilePosition pauseFilePosition;
@@ -68,6 +70,8 @@ private:
 	char *codeBuffer;
 	volatile uint16_t rxPointer, txPointer, txEnd;
 	volatile bool sendBufferUpdate;
+	bool codeStarved[NumGCodeChannels];									// true if the channel is executing a file and FillBuffer found no code for it
+	uint32_t codeStarvationCount[NumGCodeChannels];						// how many times each channel has run out of codes while executing a file
 
 	uint32_t iapWritePointer;
 	uint32_t iapRamAvailable;											// must be at least 64Kb otherwise the SPI IAP can't work
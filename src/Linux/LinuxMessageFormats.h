@@ -18,7 +18,7 @@ constexpr uint8_t LinuxFormatCode = 0x5F;			// standard format code for RRF SPI
 constexpr uint8_t LiunxFormatCodeStandalone = 0x60;	// used to indicate that RRF is running in stand-alone mode
 constexpr uint8_t InvalidFormatCode = 0xC9;			// must be different from any other format code
 
-constexpr uint16_t LinuxProtocolVersion = 5;
+constexpr uint16_t LinuxProtocolVersion = 6;			// version 6 added LinuxRequest::GetObjectModelBatch
 
 #if !LPC17xx
 constexpr size_t LinuxTransferBufferSize = 8192;	// maximum length of a data transfer. Must be a multiple of 4 and kept in sync with Duet Control Server!
@@ -244,7 +244,10 @@ enum class LinuxRequest : uint16_t
 	SetVariable = 20,							// Assign a variable (global, set, var)
 	DeleteLocalVariable = 21,					// Delete an existing local variable at the end of a code block
 
-	InvalidRequest = 22
+	InvalidRequest = 22,						// Not a valid request. Keep this value unchanged, older peers use it.
+	GetObjectModelBatch = 23,					// Request several parts of the machine's object model in one packet (protocol version 6 and later)
+
+	LastRequest = GetObjectModelBatch			// The highest valid request code
 };
 
 struct AssignFilamentHeader
@@ -306,6 +309,24 @@ struct GetObjectModelHeader
 	uint16_t flagsLength;
 };
 
+// A batched object model request is a GetObjectModelBatchHeader followed by the flags (padded to a multiple of 4 bytes),
+// then numKeys GetObjectModelBatchEntry items, each followed by its key (padded to a multiple of 4 bytes).
+// The response is a JSON array with one element per key, in request order. Keys that did not fit in the response are left out.
+struct GetObjectModelBatchHeader
+{
+	uint16_t numKeys;
+	uint16_t flagsLength;						// the flags apply to every key
+};
+
+constexpr uint32_t NoSequenceFilter = 0xFFFFFFFF;
+
+struct GetObjectModelBatchEntry
+{
+	uint32_t lastSeq;							// if the key is covered by a sequence number that still has this value, only the sequence number is returned
+	uint16_t keyLength;
+	uint16_t padding;
+};
+
 struct MacroCompleteHeader
 {
 	uint8_t channel;
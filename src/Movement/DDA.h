@@ -96,6 +96,7 @@ public:
 	float AdvanceBabyStepping(DDARing& ring, size_t axis, float amount) noexcept;	// Try to push babystepping earlier in the move queue
 	const Tool *GetTool() const noexcept { return tool; }
 	float GetTotalDistance() const noexcept { return totalDistance; }
+	float GetExtrusion(size_t extruder) const noexcept { return totalDistance * directionVector[ExtruderToLogicalDrive(extruder)]; }	// Get the amount of filament this move feeds through an extruder
 	void LimitSpeedAndAcceleration(float maxSpeed, float maxAcceleration) noexcept;	// Limit the speed an acceleration of this move
 
 	// Filament monitor support
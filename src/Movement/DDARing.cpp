@@ -10,6 +10,7 @@
 #include "Move.h"
 #include <Platform/Tasks.h>
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
+#include <Tools/Tool.h>
 
 #if SUPPORT_CAN_EXPANSION
 # include "CAN/CanMotion.h"
@@ -536,6 +537,62 @@ int32_t DDARing::GetAccumulatedExtrusion(size_t extruder, size_t drive, bool& is
 	return ret + adjustment;
 }
 
+// Return the average rate in mm/sec at which the queued moves will feed filament through the extruders of tools that use the specified heater,
+// over a window of time that starts the specified number of step clocks from now. This is called by the heater task, so it only reads the DDAs.
+// If the window extends beyond the end of the queued moves then we move it back so that it ends with them, because the extrusion rate
+// at the end of the queue is a better guess at what comes next than zero.
+float DDARing::GetFutureExtrusionRate(unsigned int heater, uint32_t ticksAhead, uint32_t windowTicks) const noexcept
+{
+	const uint32_t now = StepTimer::GetTimerTicks();
+
+	// Call the function for each move that is executing or queued, passing the start and end times of the move relative to now
+	const auto walkMoves = [this, now](function_ref<void(const DDA&, int32_t, int32_t)> func) noexcept
+	{
+		const DDA * const cdda = currentDda;						// capture volatile variable
+		const DDA *dda = (cdda != nullptr) ? cdda : getPointer;
+		int32_t moveStart = 0;
+		for (unsigned int i = 0; i < numDdasInRing; ++i)
+		{
+			const DDA::DDAState st = dda->GetState();
+			if (st == DDA::executing || st == DDA::frozen)
+			{
+				moveStart = (int32_t)(dda->GetMoveFinishTime() - dda->GetClocksNeeded() - now);
+			}
+			else if (st != DDA::provisional)
+			{
+				break;
+			}
+			const int32_t moveEnd = moveStart + (int32_t)dda->GetClocksNeeded();	// provisional moves are assumed to follow on from the previous one
+			func(*dda, moveStart, moveEnd);
+			moveStart = moveEnd;
+			dda = dda->GetNext();
+		}
+	};
+
+	int32_t queueEnd = 0;
+	walkMoves([&queueEnd](const DDA&, int32_t, int32_t moveEnd) noexcept { queueEnd = moveEnd; });
+
+	const int32_t windowStart = max<int32_t>(min<int32_t>((int32_t)ticksAhead, queueEnd - (int32_t)windowTicks), 0);
+	const int32_t windowEnd = windowStart + (int32_t)windowTicks;
+	float extrusion = 0.0;
+	walkMoves([heater, windowStart, windowEnd, &extrusion](const DDA& dda, int32_t moveStart, int32_t moveEnd) noexcept
+				{
+					const Tool * const tool = dda.GetTool();
+					if (moveEnd > windowStart && moveStart < windowEnd && moveEnd > moveStart && tool != nullptr && tool->UsesHeater(heater))
+					{
+						float moveExtrusion = 0.0;
+						for (size_t i = 0; i < tool->DriveCount(); ++i)
+						{
+							moveExtrusion += dda.GetExtrusion(tool->Drive(i));
+						}
+						const int32_t overlap = min<int32_t>(moveEnd, windowEnd) - max<int32_t>(moveStart, windowStart);
+						extrusion += moveExtrusion * (float)overlap/(float)(moveEnd - moveStart);
+					}
+				});
+
+	return max<float>(extrusion, 0.0) * (float)StepTimer::GetTickRate()/(float)windowTicks;		// ignore a net retraction
+}
+
 // Return the untransformed machine coordinates
 void DDARing::GetCurrentMachinePosition(float m[MaxAxes], bool disableMotorMapping) const noexcept
 {
@@ -40,6 +40,7 @@ public:
 	bool ScheduleNextStepInterrupt() noexcept SPEED_CRITICAL;							// Schedule the next step interrupt, returning true if we failed because it is due immediately
 	void CurrentMoveCompleted() noexcept SPEED_CRITICAL;								// Signal that the current move has just been completed
 
+	float GetFutureExtrusionRate(unsigned int heater, uint32_t ticksAhead, uint32_t windowTicks) const noexcept;	// Get the rate that queued moves will feed filament through the extruders heated by a heater
 	uint32_t ExtruderPrintingSince() const noexcept { return extrudersPrintingSince; }	// When we started doing normal moves after the most recent extruder-only move
 	int32_t GetAccumulatedExtrusion(size_t extruder, size_t drive, bool& isPrinting) noexcept;
 
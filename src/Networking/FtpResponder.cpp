@@ -15,7 +15,7 @@
 #include <Platform/Platform.h>
 
 FtpResponder::FtpResponder(NetworkResponder *n) noexcept
-	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), haveFileToMove(false)
+	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), readAheadBuffer(nullptr), restartOffset(0), haveFileToMove(false)
 {
 }
 
@@ -28,6 +28,7 @@ bool FtpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		if (outBuf != nullptr || OutputBuffer::Allocate(outBuf))
 		{
 			clientPointer = 0;
+			restartOffset = 0;
 			skt = s;
 			if (reprap.Debug(moduleWebserver))
 			{
@@ -281,14 +282,18 @@ void FtpResponder::SendPassiveData() noexcept
 	// If we have a file buffer here, we must be in the process of sending a file
 	while (fileBuffer != nullptr)
 	{
-		if (fileBuffer->IsEmpty() && fileBeingSent != nullptr)
+		if (fileBuffer->IsEmpty())
 		{
-			const int bytesRead = fileBuffer->ReadFromFile(fileBeingSent);
-			if (bytesRead != (int)NetworkBuffer::bufferSize)
+			if (readAheadBuffer != nullptr)
 			{
-				// We had a read error or we reached the end of the file
-				fileBeingSent->Close();
-				fileBeingSent = nullptr;
+				// Switch to the block we read while the previous one was being sent
+				fileBuffer->Release();
+				fileBuffer = readAheadBuffer;
+				readAheadBuffer = nullptr;
+			}
+			else if (fileBeingSent != nullptr)
+			{
+				ReadFileInto(fileBuffer);
 			}
 		}
 
@@ -321,15 +326,25 @@ void FtpResponder::SendPassiveData() noexcept
 					}
 					fileBuffer->Release();
 					fileBuffer = nullptr;
+					if (readAheadBuffer != nullptr)
+					{
+						readAheadBuffer->Release();
+						readAheadBuffer = nullptr;
+					}
 
 					responderState = ResponderState::pasvTransferComplete;
 				}
+				else
+				{
+					ReadAhead();
+				}
 				return;
 			}
 
 			fileBuffer->Taken(sent);
 			if (sent < remaining)
 			{
+				ReadAhead();				// the socket is busy, so use the time to fetch the next block from the file
 				return;
 			}
 		}
@@ -343,32 +358,67 @@ void FtpResponder::SendPassiveData() noexcept
 	responderState = ResponderState::pasvTransferComplete;
 }
 
+// Read the next block of the file being sent into the specified buffer, closing the file when we reach the end of it
+void FtpResponder::ReadFileInto(NetworkBuffer *buf) noexcept
+{
+	const int bytesRead = buf->ReadFromFile(fileBeingSent);
+	if (bytesRead != (int)NetworkBuffer::bufferSize)
+	{
+		// We had a read error or we reached the end of the file
+		fileBeingSent->Close();
+		fileBeingSent = nullptr;
+	}
+}
+
+// If the data socket can't take any more data at present, read the next block of the file so that it is ready when the socket is
+void FtpResponder::ReadAhead() noexcept
+{
+	if (fileBeingSent != nullptr && readAheadBuffer == nullptr)
+	{
+		readAheadBuffer = NetworkBuffer::Allocate();
+		if (readAheadBuffer != nullptr)
+		{
+			ReadFileInto(readAheadBuffer);
+		}
+	}
+}
+
 // Write some more upload data
 void FtpResponder::DoUpload() noexcept
 {
-	// Write incoming data to the file
+	// Write all the incoming data that the file can accept
 	const uint8_t *buffer;
 	size_t len;
-	if (dataSocket->ReadBuffer(buffer, len))
+	while (dataSocket->ReadBuffer(buffer, len))
 	{
-		if (reprap.Debug(moduleWebserver))
+		if (!dummyUpload)
 		{
-			GetPlatform().MessageF(UsbMessage, "Writing %u bytes of upload data\n", len);
-		}
+			// Don't write more than the file can accept without blocking, so that we keep servicing the main FTP port.
+			// When the file's write buffer is empty it accepts the whole chunk, so sector-aligned data can go straight to the card.
+			const size_t canWrite = (size_t)fileBeingUploaded.CanWrite();
+			if (canWrite == 0) break;
+			if (len > canWrite) len = canWrite;
 
-		dataSocket->Taken(len);
-		if (!fileBeingUploaded.Write(buffer, len))
-		{
-			uploadError = true;
-			GetPlatform().Message(ErrorMessage, "FTP: could not write upload data\n");
-			CancelUpload();
+			if (reprap.Debug(moduleWebserver))
+			{
+				GetPlatform().MessageF(UsbMessage, "Writing %u bytes of upload data\n", len);
+			}
+
+			if (!fileBeingUploaded.Write(buffer, len))
+			{
+				uploadError = true;
+				GetPlatform().Message(ErrorMessage, "FTP: could not write upload data\n");
+				CancelUpload();
 
-			responderState = ResponderState::pasvTransferComplete;
-			return;
+				responderState = ResponderState::pasvTransferComplete;
+				return;
+			}
 		}
+		dataSocket->Taken(len);							// the socket may release the buffer, so don't call this until we have written the data
+		uploadedBytes += len;
 	}
 
-	// Upload has finished if the connection is closed
+	// Upload has finished if the connection is closed and we have written all the data
 	if (!dataSocket->CanRead())
 	{
 		dataSocket = nullptr;
@@ -501,6 +551,8 @@ void FtpResponder::ProcessLine() noexcept
 		{
 			outBuf->copy(	"211-Features:\r\n"
 							"PASV\r\n"			// support PASV mode
+							"REST STREAM\r\n"	// support resuming transfers
+							"SIZE\r\n"			// support file size queries
 							"211 End\r\n"
 						);
 			Commit(ResponderState::reading);
@@ -540,6 +592,16 @@ void FtpResponder::ProcessLine() noexcept
 			}
 			Commit(ResponderState::reading);
 		}
+		// set the offset for the next transfer
+		else if (StringStartsWith(clientMessage, "REST"))
+		{
+			ProcessRest(ResponderState::reading);
+		}
+		// get file size
+		else if (StringStartsWith(clientMessage, "SIZE"))
+		{
+			ProcessSize(ResponderState::reading);
+		}
 		// enter passive mode mode
 		else if (StringEqualsIgnoreCase(clientMessage, "PASV"))
 		{
@@ -710,6 +772,16 @@ void FtpResponder::ProcessLine() noexcept
 			}
 			Commit(ResponderState::pasvPortOpened);
 		}
+		// set the offset for the next transfer
+		else if (StringStartsWith(clientMessage, "REST"))
+		{
+			ProcessRest(ResponderState::pasvPortOpened);
+		}
+		// get file size
+		else if (StringStartsWith(clientMessage, "SIZE"))
+		{
+			ProcessSize(ResponderState::pasvPortOpened);
+		}
 		// upload a file
 		else if (StringStartsWith(clientMessage, "STOR"))
 		{
@@ -718,7 +790,11 @@ void FtpResponder::ProcessLine() noexcept
 			filenameBeingProcessed.Clear();
 
 			const char * const filename = GetParameter("STOR");
-			if (StartUpload(currentDirectory.c_str(), filename, OpenMode::write))
+			const bool ok = (restartOffset == 0)
+							? StartUpload(currentDirectory.c_str(), filename, OpenMode::write)
+							: ResumeUpload(currentDirectory.c_str(), filename, restartOffset);
+			restartOffset = 0;
+			if (ok)
 			{
 				outBuf->copy("150 OK to send data.\r\n");
 				Commit(ResponderState::uploading);
@@ -734,9 +810,14 @@ void FtpResponder::ProcessLine() noexcept
 		{
 			const char * const filename = GetParameter("RETR");
 			fileBeingSent = GetPlatform().OpenFile(currentDirectory.c_str(), filename, OpenMode::read);
+			if (fileBeingSent != nullptr && restartOffset != 0 && (restartOffset > fileBeingSent->Length() || !fileBeingSent->Seek(restartOffset)))
+			{
+				fileBeingSent->Close();
+				fileBeingSent = nullptr;
+			}
 			if (fileBeingSent != nullptr)
 			{
-				outBuf->printf("150 Opening data connection for %s (%lu bytes).\r\n", filename, fileBeingSent->Length());
+				outBuf->printf("150 Opening data connection for %s (%lu bytes).\r\n", filename, fileBeingSent->Length() - restartOffset);
 				Commit(ResponderState::sendingPasvData);
 			}
 			else
@@ -744,6 +825,7 @@ void FtpResponder::ProcessLine() noexcept
 				outBuf->copy("550 Failed to open file.\r\n");
 				Commit(ResponderState::reading);
 			}
+			restartOffset = 0;
 		}
 		// abort current operation
 		else if (StringEqualsIgnoreCase(clientMessage, "ABOR"))
@@ -906,6 +988,54 @@ void FtpResponder::CloseDataPort() noexcept
 		fileBeingSent->Close();
 		fileBeingSent = nullptr;
 	}
+
+	// Discard any file data we read but didn't send, e.g. because the transfer was aborted
+	if (fileBuffer != nullptr)
+	{
+		fileBuffer->Release();
+		fileBuffer = nullptr;
+	}
+	if (readAheadBuffer != nullptr)
+	{
+		readAheadBuffer->Release();
+		readAheadBuffer = nullptr;
+	}
+}
+
+// Process a REST command, which sets the offset at which the next RETR or STOR command starts
+void FtpResponder::ProcessRest(ResponderState nextState) noexcept
+{
+	const char * const param = GetParameter("REST");
+	const char *endp;
+	const uint32_t offset = StrToU32(param, &endp);
+	if (endp != param && *endp == 0)
+	{
+		restartOffset = offset;
+		outBuf->printf("350 Restarting at %" PRIu32 ".\r\n", offset);
+	}
+	else
+	{
+		restartOffset = 0;
+		outBuf->copy("501 Invalid restart position.\r\n");
+	}
+	Commit(nextState);
+}
+
+// Process a SIZE command. Clients use this to find out how much of a file they have already transferred before resuming it.
+void FtpResponder::ProcessSize(ResponderState nextState) noexcept
+{
+	const char * const filename = GetParameter("SIZE");
+	FileStore * const file = GetPlatform().OpenFile(currentDirectory.c_str(), filename, OpenMode::read);
+	if (file != nullptr)
+	{
+		outBuf->printf("213 %lu\r\n", file->Length());
+		file->Close();
+	}
+	else
+	{
+		outBuf->copy("550 Could not get file size.\r\n");
+	}
+	Commit(nextState);
 }
 
 /*static*/ void FtpResponder::InitStatic() noexcept
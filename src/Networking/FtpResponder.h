@@ -28,12 +28,16 @@ protected:
 	void ConnectionLost() noexcept override;
 	void SendData() noexcept override;
 	void SendPassiveData() noexcept;
+	void ReadFileInto(NetworkBuffer *buf) noexcept;
+	void ReadAhead() noexcept;
 	void DoUpload() noexcept;
 	bool ReadData() noexcept;
 	void CharFromClient(char c) noexcept;
 	void ProcessLine() noexcept;
 	const char *GetParameter(const char *after) const noexcept;	// return the parameter followed by whitespaces after a command
 	void ChangeDirectory(const char *newDirectory) noexcept;
+	void ProcessRest(ResponderState nextState) noexcept;
+	void ProcessSize(ResponderState nextState) noexcept;
 	void CloseDataPort() noexcept;
 
 	static const size_t ftpMessageLength = 128;			// maximum line length for incoming FTP commands
@@ -43,6 +47,8 @@ protected:
 	TcpPort passivePort;
 	uint32_t passivePortOpenTime;
 	OutputBuffer *dataBuf;
+	NetworkBuffer *readAheadBuffer;						// next block of the file being sent, read while the previous block is still being sent
+	FilePosition restartOffset;							// offset set by the REST command for the next RETR or STOR
 
 	bool sendError;
 	bool haveCompleteLine;
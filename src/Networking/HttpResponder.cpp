@@ -24,6 +24,10 @@ static_assert(ARRAY_SIZE(serviceUnavailableResponse) <= OUTPUT_BUFFER_SIZE, "OUT
 
 const uint32_t HttpReceiveTimeout = 2000;
 
+#if SUPPORT_OBJECT_MODEL
+const size_t MaxModelWaiters = NumHttpResponders - 1;		// leave at least one responder free for other requests
+#endif
+
 // Text for a human-readable 404 page
 const char* const ErrorPagePart1 =
 	"<html>\n"
@@ -48,14 +52,7 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		responderState = ResponderState::reading;
 		skt = s;
 		timer = millis();
-
-		// Reset the parse state variables
-		clientPointer = 0;
-		parseState = HttpParseState::doingCommandWord;
-		numCommandWords = 0;
-		numQualKeys = 0;
-		numHeaderKeys = 0;
-		commandWords[0] = clientMessage;
+		ResetParser();
 
 		if (reprap.Debug(moduleWebserver))
 		{
@@ -66,6 +63,18 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 	return false;
 }
 
+// Reset the parse state variables ready to receive a new request on this connection
+void HttpResponder::ResetParser() noexcept
+{
+	clientPointer = 0;
+	parseState = HttpParseState::doingCommandWord;
+	numCommandWords = 0;
+	numQualKeys = 0;
+	numHeaderKeys = 0;
+	commandWords[0] = clientMessage;
+	modelWaitFinished = false;
+}
+
 // Do some work, returning true if we did anything significant
 bool HttpResponder::Spin() noexcept
 {
@@ -76,11 +85,23 @@ bool HttpResponder::Spin() noexcept
 
 	case ResponderState::reading:
 		{
+			// Parse the request directly from the socket's receive buffers instead of fetching one character at a time.
+			// We only mark as taken the characters that belong to this request, so that if the client has pipelined
+			// further requests on a persistent connection, they remain in the socket for us to process next.
 			bool readSomething = false;
-			char c;
-			while (skt->ReadChar(c))
+			const uint8_t *data;
+			size_t len;
+			while (skt->ReadBuffer(data, len) && len != 0)
 			{
-				if (CharFromClient(c))
+				size_t consumed = 0;
+				bool finished = false;
+				do
+				{
+					finished = CharFromClient((char)data[consumed++]);
+				} while (!finished && consumed < len);
+
+				skt->Taken(consumed);
+				if (finished)
 				{
 					timer = millis();		// restart the timeout
 					return true;
@@ -112,6 +133,28 @@ bool HttpResponder::Spin() noexcept
 		(void)SendFileInfo(millis() - startedProcessingRequestAt >= MaxFileInfoGetTime);
 		return true;
 
+#if SUPPORT_OBJECT_MODEL
+	case ResponderState::waitingForModelChange:
+		{
+			const uint32_t waitedFor = millis() - startedProcessingRequestAt;
+			if (waitedFor >= modelWaitTimeout || (waitedFor >= modelMinInterval && reprap.GetModelSeq() != modelSeqWaitedFor))
+			{
+				// Process the request again, this time sending the response
+				--numModelWaiters;
+				modelWaitFinished = true;
+				responderState = ResponderState::processingRequest;
+				return true;
+			}
+			if (!skt->CanRead())
+			{
+				--numModelWaiters;
+				ConnectionLost();					// the client has gone away
+				return true;
+			}
+			return false;
+		}
+#endif
+
 #if HAS_MASS_STORAGE
 	case ResponderState::uploading:
 		DoUpload();
@@ -504,6 +547,7 @@ bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response
 	}
 	else if (StringEqualsIgnoreCase(request, "status"))
 	{
+		keepOpen = true;					// clients poll this continually, so it's worth persisting the connection
 		const char *typeString = GetKeyValue("type");
 		if (typeString != nullptr)
 		{
@@ -619,10 +663,55 @@ bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response
 #if SUPPORT_OBJECT_MODEL
 	else if (StringEqualsIgnoreCase(request, "model"))
 	{
-		OutputBuffer::ReleaseAll(response);
+		// If the client passed the sequence number from its previous response then it wants us to hold the request until the
+		// object model changes, instead of polling. The response is then wrapped in an object that includes the new sequence number.
+		// If too many requests are already waiting then we respond straight away, so that waiting requests can't tie up all the responders.
+		const char *const seqVal = GetKeyValue("seq");
+		if (seqVal != nullptr && !modelWaitFinished && numModelWaiters < MaxModelWaiters)
+		{
+			++numModelWaiters;
+			modelSeqWaitedFor = StrToU32(seqVal);
+			const char *const timeoutVal = GetKeyValue("timeout");
+			modelWaitTimeout = (timeoutVal == nullptr) ? DefaultModelWaitTime : min<uint32_t>(StrToU32(timeoutVal), MaxModelWaitTime);
+
+			// Live values such as temperatures, positions and fan speeds don't change any sequence number, and nearly every part of the model
+			// includes some. So unless the client only wants the sequence numbers, don't hold the request for longer than a normal status poll,
+			// otherwise the client would see stale values.
+			const char *const waitKeyVal = GetKeyValue("key");
+			if (waitKeyVal == nullptr || !StringStartsWith(waitKeyVal, "seqs"))
+			{
+				modelWaitTimeout = min<uint32_t>(modelWaitTimeout, LiveModelWaitTime);
+			}
+			const char *const intervalVal = GetKeyValue("interval");
+			modelMinInterval = min<uint32_t>((intervalVal == nullptr) ? DefaultModelMinInterval : StrToU32(intervalVal), modelWaitTimeout);
+			responderState = ResponderState::waitingForModelChange;
+			return false;
+		}
+
+		modelWaitFinished = false;
+		keepOpen = true;					// clients poll this continually, so it's worth persisting the connection
 		const char *const filterVal = GetKeyValue("key");
 		const char *const flagsVal = GetKeyValue("flags");
-		response = reprap.GetModelResponse(filterVal, flagsVal);
+		if (seqVal == nullptr)
+		{
+			OutputBuffer::ReleaseAll(response);
+			response = reprap.GetModelResponse(filterVal, flagsVal);
+		}
+		else
+		{
+			// Fetch the sequence number first, so that if the model changes while we generate the response then the next request returns immediately
+			response->printf("{\"seq\":%" PRIu32 ",\"model\":", reprap.GetModelSeq());
+			OutputBuffer * const modelResponse = reprap.GetModelResponse(filterVal, flagsVal);
+			if (modelResponse == nullptr)
+			{
+				OutputBuffer::ReleaseAll(response);
+			}
+			else
+			{
+				response->Append(modelResponse);
+				response->cat('}');
+			}
+		}
 	}
 #endif
 	else if (StringEqualsIgnoreCase(request, "config"))
@@ -639,6 +728,32 @@ bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response
 	return true;
 }
 
+// Return the value of the specified header, or nullptr if it is not present
+const char* HttpResponder::GetHeaderValue(const char *key) const noexcept
+{
+	for (size_t i = 0; i < numHeaderKeys; ++i)
+	{
+		if (StringEqualsIgnoreCase(headers[i].key, key))
+		{
+			return headers[i].value;
+		}
+	}
+	return nullptr;
+}
+
+// Return true if the client asked us to keep the connection open after sending the response to the current request
+bool HttpResponder::IsKeepAliveRequested() const noexcept
+{
+	const char * const connection = GetHeaderValue("Connection");
+	if (connection != nullptr)
+	{
+		return StringEqualsIgnoreCase(connection, "keep-alive");
+	}
+
+	// HTTP/1.1 connections are persistent unless the client says otherwise
+	return numCommandWords >= 3 && StringEqualsIgnoreCase(commandWords[2], "HTTP/1.1");
+}
+
 const char* HttpResponder::GetKeyValue(const char *key) const noexcept
 {
 	for (size_t i = 0; i < numQualKeys; ++i)
@@ -752,11 +867,228 @@ bool HttpResponder::RemoveAuthentication() noexcept
 	}
 }
 
+#if HAS_MASS_STORAGE
+
+// Return the volume number that holds the web files, or 0 if the web directory names a volume that doesn't exist
+static unsigned int GetWebVolume(const char *webDir) noexcept
+{
+	if (isdigit(webDir[0]) && webDir[1] == ':')
+	{
+		const unsigned int volume = webDir[0] - '0';
+		if (volume < NumSdCards)
+		{
+			return volume;
+		}
+	}
+	return 0;
+}
+
+// Look up a web file in the cache, returning the entry if we found it and it is still valid
+HttpResponder::WebFileCacheEntry *HttpResponder::FindWebFileCacheEntry(const char *requestedName) noexcept
+{
+	// If anything on the volume holding the web files has changed, all the entries may be stale
+	const uint16_t volSeq = MassStorage::GetVolumeSeq(GetWebVolume(GetPlatform().GetWebDir()));
+	if (volSeq != webFileCacheSeq)
+	{
+		for (WebFileCacheEntry& entry : webFileCache)
+		{
+			entry.requestedName.Clear();
+		}
+		webFileCacheSeq = volSeq;
+		return nullptr;
+	}
+
+	for (WebFileCacheEntry& entry : webFileCache)
+	{
+		if (!entry.requestedName.IsEmpty() && StringEqualsIgnoreCase(entry.requestedName.c_str(), requestedName))
+		{
+			entry.lastUsed = millis();
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+// Record how we resolved a request for a web file, replacing the least recently used entry
+void HttpResponder::AddWebFileCacheEntry(const char *requestedName, const char *nameOfFileSent, bool zip, FilePosition length, time_t lastModified) noexcept
+{
+	WebFileResolution resolution;
+	if (StringEqualsIgnoreCase(nameOfFileSent, requestedName))
+	{
+		resolution = WebFileResolution::asRequested;
+	}
+	else if (StringEqualsIgnoreCase(nameOfFileSent, INDEX_PAGE_FILE))
+	{
+		resolution = WebFileResolution::indexPage;
+	}
+	else if (StringEqualsIgnoreCase(nameOfFileSent, OLD_INDEX_PAGE_FILE))
+	{
+		resolution = WebFileResolution::oldIndexPage;
+	}
+	else if (StringEqualsIgnoreCase(nameOfFileSent, FOUR04_PAGE_FILE))
+	{
+		resolution = WebFileResolution::notFoundPage;
+	}
+	else
+	{
+		return;
+	}
+
+	if (strlen(requestedName) > MaxCachedWebFilenameLength)
+	{
+		return;
+	}
+
+	const uint32_t now = millis();
+	WebFileCacheEntry *victim = &webFileCache[0];
+	for (WebFileCacheEntry& entry : webFileCache)
+	{
+		if (entry.requestedName.IsEmpty())
+		{
+			victim = &entry;
+			break;
+		}
+		if (now - entry.lastUsed > now - victim->lastUsed)
+		{
+			victim = &entry;
+		}
+	}
+
+	victim->requestedName.copy(requestedName);
+	victim->length = length;
+	victim->lastModified = (uint32_t)lastModified;
+	victim->lastUsed = now;
+	victim->resolution = resolution;
+	victim->zip = zip;
+}
+
+// Return the name of the file that a cache entry says we should send
+/*static*/ const char *HttpResponder::GetResolvedName(const WebFileCacheEntry& entry) noexcept
+{
+	switch (entry.resolution)
+	{
+	case WebFileResolution::indexPage:		return INDEX_PAGE_FILE;
+	case WebFileResolution::oldIndexPage:	return OLD_INDEX_PAGE_FILE;
+	case WebFileResolution::notFoundPage:	return FOUR04_PAGE_FILE;
+	case WebFileResolution::asRequested:
+	default:								return entry.requestedName.c_str();
+	}
+}
+
+// Open a file in the web folder, optionally the gzipped version of it
+FileStore *HttpResponder::OpenWebFile(const char *nameOfFile, bool zip) const noexcept
+{
+	if (zip)
+	{
+		String<MaxFilenameLength> nameBuf;
+		nameBuf.copy(nameOfFile);
+		nameBuf.cat(".gz");
+		return GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameBuf.c_str(), OpenMode::read);
+	}
+	return GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameOfFile, OpenMode::read);
+}
+
+// Get the last modified time of a file in the web folder
+time_t HttpResponder::GetWebFileLastModified(const char *nameOfFile, bool zip) const noexcept
+{
+	String<MaxFilenameLength> path;
+	if (!MassStorage::CombineName(path.GetRef(), GetPlatform().GetWebDir(), nameOfFile) || (zip && path.cat(".gz")))
+	{
+		return 0;
+	}
+	return MassStorage::GetLastModifiedTime(path.c_str());
+}
+
+// Build the strong entity tag for a web file. We derive it from the file size and timestamp, so that we don't need to read the file to create it.
+/*static*/ void HttpResponder::MakeETag(const StringRef& etag, FilePosition length, time_t lastModified) noexcept
+{
+	etag.printf("\"%08" PRIx32 "-%08" PRIx32 "\"", (uint32_t)lastModified, (uint32_t)length);
+}
+
+// Return true if the If-None-Match header includes the specified entity tag
+bool HttpResponder::IsNotModified(const char *etag) const noexcept
+{
+	const char * const ifNoneMatch = GetHeaderValue("If-None-Match");
+	return ifNoneMatch != nullptr && (strcmp(ifNoneMatch, "*") == 0 || strstr(ifNoneMatch, etag) != nullptr);
+}
+
+// Send a 304 response
+void HttpResponder::SendNotModified(const char *etag) noexcept
+{
+	outBuf->copy("HTTP/1.1 304 Not Modified\r\n");
+	outBuf->catf("ETag: %s\r\n", etag);
+	outBuf->cat("Cache-Control: no-cache\r\n");
+	outBuf->cat("Connection: close\r\n\r\n");
+	Commit();
+}
+
+// Parse the Range header if there is one.
+// We only support a single range that extends to the end of the file, which is what browsers and download managers use to resume transfers.
+// For other ranges we send the whole file, which HTTP allows.
+HttpResponder::RangeResult HttpResponder::ParseRange(FilePosition fileLength, const char *etag, FilePosition& rangeStart) const noexcept
+{
+	const char *s = GetHeaderValue("Range");
+	if (s == nullptr || !StringStartsWithIgnoreCase(s, "bytes=") || strchr(s, ',') != nullptr)
+	{
+		return RangeResult::wholeFile;
+	}
+
+	// If the client made the range conditional, only honour it if the file hasn't changed
+	const char * const ifRange = GetHeaderValue("If-Range");
+	if (ifRange != nullptr && (etag == nullptr || strcmp(ifRange, etag) != 0))
+	{
+		return RangeResult::wholeFile;
+	}
+
+	s += strlen("bytes=");
+	const char *endp;
+	if (*s == '-')
+	{
+		// Suffix range, i.e. the last N bytes of the file
+		const uint32_t suffixLength = StrToU32(s + 1, &endp);
+		if (endp == s + 1)
+		{
+			return RangeResult::wholeFile;
+		}
+		if (suffixLength == 0 || fileLength == 0)
+		{
+			return RangeResult::unsatisfiable;
+		}
+		rangeStart = (suffixLength >= fileLength) ? 0 : fileLength - suffixLength;
+		return RangeResult::partial;
+	}
+
+	const uint32_t first = StrToU32(s, &endp);
+	if (endp == s || *endp != '-')
+	{
+		return RangeResult::wholeFile;
+	}
+	if (first >= fileLength)
+	{
+		return RangeResult::unsatisfiable;
+	}
+
+	s = endp + 1;
+	if (*s != 0)
+	{
+		const uint32_t last = StrToU32(s, &endp);
+		if (endp == s || last < first || last + 1 < fileLength)
+		{
+			return RangeResult::wholeFile;
+		}
+	}
+	rangeStart = first;
+	return RangeResult::partial;
+}
+
+#endif
+
 void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexcept
 {
 #if HAS_MASS_STORAGE
 	FileStore *fileToSend = nullptr;
 	bool zip = false;
+	String<StringLength20> etag;
 
 	if (isWebFile)
 	{
@@ -785,51 +1117,93 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 		}
 		else
 		{
-			for (;;)
+			// See if we have served this file before. If so then we know which file to open, and if the browser already has
+			// the current version then we can tell it so without accessing the SD card at all.
+			const WebFileCacheEntry * const cacheEntry = FindWebFileCacheEntry(nameOfFileToSend);
+			if (cacheEntry != nullptr)
 			{
-				// Try to open a gzipped version of the file first
-				if (!StringEndsWithIgnoreCase(nameOfFileToSend, ".gz") && strlen(nameOfFileToSend) + 3 <= MaxFilenameLength)
+				MakeETag(etag.GetRef(), cacheEntry->length, cacheEntry->lastModified);
+				if (IsNotModified(etag.c_str()))
 				{
-					String<MaxFilenameLength> nameBuf;
-					nameBuf.copy(nameOfFileToSend);
-					nameBuf.cat(".gz");
-					fileToSend = GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameBuf.c_str(), OpenMode::read);
-					if (fileToSend != nullptr)
-					{
-						zip = true;
-						break;
-					}
+					++numNotModifiedResponses;
+					SendNotModified(etag.c_str());
+					return;
 				}
 
-				// That failed, so try to open the normal version of the file
-				fileToSend = GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameOfFileToSend, OpenMode::read);
+				zip = cacheEntry->zip;
+				const char * const resolvedName = GetResolvedName(*cacheEntry);
+				fileToSend = OpenWebFile(resolvedName, zip);
 				if (fileToSend != nullptr)
 				{
-					break;
+					nameOfFileToSend = resolvedName;			// so that we get the content type right
 				}
+				else
+				{
+					zip = false;								// the entry was stale, so look for the file again
+					etag.Clear();
+				}
+			}
 
-				if (StringEqualsIgnoreCase(nameOfFileToSend, INDEX_PAGE_FILE))
+			if (fileToSend == nullptr)
+			{
+				const char * const requestedName = nameOfFileToSend;
+				for (;;)
 				{
-					nameOfFileToSend = OLD_INDEX_PAGE_FILE;			// the index file wasn't found, so try the old one
+					// Try to open a gzipped version of the file first
+					if (!StringEndsWithIgnoreCase(nameOfFileToSend, ".gz") && strlen(nameOfFileToSend) + 3 <= MaxFilenameLength)
+					{
+						fileToSend = OpenWebFile(nameOfFileToSend, true);
+						if (fileToSend != nullptr)
+						{
+							zip = true;
+							break;
+						}
+					}
+
+					// That failed, so try to open the normal version of the file
+					fileToSend = OpenWebFile(nameOfFileToSend, false);
+					if (fileToSend != nullptr)
+					{
+						break;
+					}
+
+					if (StringEqualsIgnoreCase(nameOfFileToSend, INDEX_PAGE_FILE))
+					{
+						nameOfFileToSend = OLD_INDEX_PAGE_FILE;			// the index file wasn't found, so try the old one
+					}
+					else if (!strchr(nameOfFileToSend, '.'))			// if we were asked to return a file without a '.' in the name, return the index page
+					{
+						nameOfFileToSend = INDEX_PAGE_FILE;
+					}
+					else
+					{
+						break;
+					}
 				}
-				else if (!strchr(nameOfFileToSend, '.'))			// if we were asked to return a file without a '.' in the name, return the index page
+
+				// If we still couldn't find the file and it was an HTML file, return the 404 error page
+				if (fileToSend == nullptr && (StringEndsWithIgnoreCase(nameOfFileToSend, ".html") || StringEndsWithIgnoreCase(nameOfFileToSend, ".htm")))
 				{
-					nameOfFileToSend = INDEX_PAGE_FILE;
+					nameOfFileToSend = FOUR04_PAGE_FILE;
+					fileToSend = OpenWebFile(nameOfFileToSend, false);
 				}
-				else
+
+				if (fileToSend != nullptr)
 				{
-					break;
+					const time_t lastModified = GetWebFileLastModified(nameOfFileToSend, zip);
+					AddWebFileCacheEntry(requestedName, nameOfFileToSend, zip, fileToSend->Length(), lastModified);
+					MakeETag(etag.GetRef(), fileToSend->Length(), lastModified);
+					if (IsNotModified(etag.c_str()))
+					{
+						fileToSend->Close();
+						++numNotModifiedResponses;
+						SendNotModified(etag.c_str());
+						return;
+					}
 				}
 			}
 		}
 
-		// If we still couldn't find the file and it was an HTML file, return the 404 error page
-		if (fileToSend == nullptr && (StringEndsWithIgnoreCase(nameOfFileToSend, ".html") || StringEndsWithIgnoreCase(nameOfFileToSend, ".htm")))
-		{
-			nameOfFileToSend = FOUR04_PAGE_FILE;
-			fileToSend = GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameOfFileToSend, OpenMode::read);
-		}
-
 		if (fileToSend == nullptr)
 		{
 			RejectMessage("page not found<br>Check that the SD card is mounted and has the correct files in its /www folder", 404);
@@ -846,10 +1220,31 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 		}
 	}
 
+	const FilePosition fileLength = fileToSend->Length();
+	FilePosition rangeStart = 0;
+	const RangeResult rangeResult = ParseRange(fileLength, (etag.IsEmpty()) ? nullptr : etag.c_str(), rangeStart);
+	if (rangeResult == RangeResult::unsatisfiable)
+	{
+		fileToSend->Close();
+		outBuf->printf("HTTP/1.1 416 Range Not Satisfiable\r\n"
+					   "Content-Range: bytes */%lu\r\n"
+					   "Content-Length: 0\r\n", fileLength);
+		AddCorsHeader();
+		outBuf->cat("Connection: close\r\n\r\n");
+		Commit();
+		return;
+	}
+	if (rangeResult == RangeResult::partial && !fileToSend->Seek(rangeStart))
+	{
+		fileToSend->Close();
+		RejectMessage("file seek failed");
+		return;
+	}
+
 	fileBeingSent = fileToSend;
-	outBuf->copy("HTTP/1.1 200 OK\r\n");
+	outBuf->copy((rangeResult == RangeResult::partial) ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n");
 
-	// Don't cache files served by rr_download
+	// Don't cache files served by rr_download. Web files may be cached, but the browser must check with us that they haven't changed.
 	if (!isWebFile)
 	{
 		outBuf->cat(	"Cache-Control: no-cache, no-store, must-revalidate\r\n"
@@ -858,6 +1253,12 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 					);
 		AddCorsHeader();
 	}
+	else if (!etag.IsEmpty())
+	{
+		outBuf->catf("ETag: %s\r\n", etag.c_str());
+		outBuf->cat("Cache-Control: no-cache\r\n");
+	}
+	outBuf->cat("Accept-Ranges: bytes\r\n");
 
 	const char* contentType;
 	if (StringEndsWithIgnoreCase(nameOfFileToSend, ".png"))
@@ -900,7 +1301,11 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 		outBuf->cat("Content-Encoding: gzip\r\n");
 	}
 
-	outBuf->catf("Content-Length: %lu\r\n", fileToSend->Length());
+	if (rangeResult == RangeResult::partial)
+	{
+		outBuf->catf("Content-Range: bytes %lu-%lu/%lu\r\n", rangeStart, fileLength - 1, fileLength);
+	}
+	outBuf->catf("Content-Length: %lu\r\n", fileLength - rangeStart);
 	outBuf->cat("Connection: close\r\n\r\n");
 	Commit();
 #else
@@ -1020,21 +1425,8 @@ void HttpResponder::SendJsonResponse(const char* command) noexcept
 		return;
 	}
 
-	// Send the JSON response
-	bool keepOpen = false;
-	if (mayKeepOpen)
-	{
-		// Check that the browser wants to persist the connection too
-		for (size_t i = 0; i < numHeaderKeys; ++i)
-		{
-			if (StringEqualsIgnoreCase(headers[i].key, "Connection"))
-			{
-				// Comment out the following line to disable persistent connections
-				keepOpen = StringEqualsIgnoreCase(headers[i].value, "keep-alive");
-				break;
-			}
-		}
-	}
+	// Send the JSON response, persisting the connection if the browser wants that too
+	const bool keepOpen = mayKeepOpen && IsKeepAliveRequested();
 
 	// Note that when using RTOS the following response should preferably be small enough to fit in a single buffer.
 	// This is because the current task may get suspended e.g. when reading from SD card to build a file list,
@@ -1221,8 +1613,6 @@ void HttpResponder::ProcessRequest() noexcept
 					{
 						GetPlatform().MessageF(UsbMessage, "Start uploading file %s length %lu\n", filename, postFileLength);
 					}
-					uploadedBytes = 0;
-
 					// Keep track of the connection that is now uploading
 					const IPAddress remoteIP = GetRemoteIP();
 					const uint16_t remotePort = skt->GetRemotePort();
@@ -1293,8 +1683,8 @@ void HttpResponder::DoUpload() noexcept
 	{
 		if (!dummyUpload)
 		{
-			// Check to see how much we can write, this avaoid blocking when using a 
-			// writer task and provides better throughput
+			// Check to see how much we can write, this avoids blocking when using a writer task and provides better throughput.
+			// When the file's write buffer is empty we can write the whole chunk, so that sector-aligned data can go straight to the card.
 			size_t canWrite = (size_t)fileBeingUploaded.CanWrite();
 			if (canWrite == 0) break;
 			if (len > canWrite) len = canWrite;
@@ -1349,6 +1739,12 @@ void HttpResponder::Terminate(NetworkProtocol protocol, NetworkInterface *interf
 {
 	if (responderState != ResponderState::free && (protocol == HttpProtocol || protocol == AnyProtocol) && skt != nullptr && skt->GetInterface() == interface)
 	{
+#if SUPPORT_OBJECT_MODEL
+		if (responderState == ResponderState::waitingForModelChange)
+		{
+			--numModelWaiters;
+		}
+#endif
 		ConnectionLost();
 	}
 }
@@ -1377,6 +1773,9 @@ void HttpResponder::SendData() noexcept
 	NetworkResponder::SendData();
 	if (responderState == ResponderState::reading)
 	{
+		// We kept the connection open, so get ready to parse the next request. The client may already have sent it.
+		ResetParser();
+		++numKeepAliveRequests;
 		timer = millis();				// restart the timer
 	}
 }
@@ -1507,7 +1906,12 @@ void HttpResponder::Diagnostics(MessageType mt) const noexcept
 
 /*static*/ void HttpResponder::CommonDiagnostics(MessageType mtype) noexcept
 {
-	GetPlatform().MessageF(mtype, "HTTP sessions: %u of %u\n", numSessions, MaxHttpSessions);
+	GetPlatform().MessageF(mtype, "HTTP sessions: %u of %u, persistent connection reuses: %u\n", numSessions, MaxHttpSessions, numKeepAliveRequests);
+	numKeepAliveRequests = 0;
+#if HAS_MASS_STORAGE
+	GetPlatform().MessageF(mtype, "Web files not modified/cache entries: %u/%u\n", numNotModifiedResponses, NumWebFileCacheEntries);
+	numNotModifiedResponses = 0;
+#endif
 	GetPlatform().MessageF(mtype, "Uploads/Errors: %u/%u\n", numUploads, numUploadErrors);
 	numUploads = numUploadErrors = 0;
 }
@@ -1525,6 +1929,17 @@ void HttpResponder::AddCorsHeader() noexcept
 HttpResponder::HttpSession HttpResponder::sessions[MaxHttpSessions];
 unsigned int HttpResponder::numSessions = 0;
 unsigned int HttpResponder::clientsServed = 0;
+unsigned int HttpResponder::numKeepAliveRequests = 0;
+
+#if SUPPORT_OBJECT_MODEL
+size_t HttpResponder::numModelWaiters = 0;
+#endif
+
+#if HAS_MASS_STORAGE
+HttpResponder::WebFileCacheEntry HttpResponder::webFileCache[NumWebFileCacheEntries];
+uint16_t HttpResponder::webFileCacheSeq = 0;
+unsigned int HttpResponder::numNotModifiedResponses = 0;
+#endif
 
 volatile uint16_t HttpResponder::seq = 0;
 volatile OutputStack HttpResponder::gcodeReply;
@@ -44,6 +44,16 @@ private:
 	static const uint32_t HttpSessionTimeout = 8000;	// HTTP session timeout in milliseconds
 	static const uint32_t MaxFileInfoGetTime = 2000;	// maximum length of time we spend getting file info, to avoid the client timing out (actual time will be a little longer than this)
 	static const uint32_t MaxBufferWaitTime = 1000;		// maximum length of time we spend waiting for a buffer before we discard gcodeReply buffers
+#if LPC17xx
+	static const size_t NumWebFileCacheEntries = 4;		// how many web files we remember the location, size and timestamp of
+#else
+	static const size_t NumWebFileCacheEntries = 16;	// how many web files we remember the location, size and timestamp of
+#endif
+	static const size_t MaxCachedWebFilenameLength = 40;	// longest requested web file name that we cache
+	static const uint32_t DefaultModelWaitTime = 4000;	// default length of time we hold an rr_model request waiting for the object model to change
+	static const uint32_t MaxModelWaitTime = 6000;		// maximum length of time we hold an rr_model request, must be less than HttpSessionTimeout
+	static const uint32_t DefaultModelMinInterval = 250;	// default minimum time between rr_model responses when the client is waiting for changes
+	static const uint32_t LiveModelWaitTime = 250;		// maximum time we hold an rr_model request whose response includes live values, the same as a normal status poll
 
 	enum class HttpParseState
 	{
@@ -67,6 +77,33 @@ private:
 		const char* value;
 	};
 
+	// Which file we sent in response to a request for a web file
+	enum class WebFileResolution : uint8_t
+	{
+		asRequested,
+		indexPage,
+		oldIndexPage,
+		notFoundPage
+	};
+
+	// Details of a web file we served recently, so that we can validate the browser's copy or open the right file without searching for it
+	struct WebFileCacheEntry
+	{
+		String<MaxCachedWebFilenameLength> requestedName;	// empty if the entry is not in use
+		FilePosition length;
+		uint32_t lastModified;
+		uint32_t lastUsed;
+		WebFileResolution resolution;
+		bool zip;
+	};
+
+	enum class RangeResult : uint8_t
+	{
+		wholeFile,
+		partial,
+		unsatisfiable
+	};
+
 	// HTTP sessions
 	struct HttpSession
 	{
@@ -80,6 +117,7 @@ private:
 	bool CheckAuthenticated() noexcept;
 	bool RemoveAuthentication() noexcept;
 
+	void ResetParser() noexcept;
 	bool CharFromClient(char c) noexcept;
 	void SendFile(const char* nameOfFileToSend, bool isWebFile) noexcept;
 	void SendGCodeReply() noexcept;
@@ -90,12 +128,25 @@ private:
 	void RejectMessage(const char* s, unsigned int code = 500) noexcept;
 	bool SendFileInfo(bool quitEarly) noexcept;
 	void AddCorsHeader() noexcept;
+	bool IsKeepAliveRequested() const noexcept;
 
 #if HAS_MASS_STORAGE
 	void DoUpload() noexcept;
+
+	WebFileCacheEntry *FindWebFileCacheEntry(const char *requestedName) noexcept;
+	void AddWebFileCacheEntry(const char *requestedName, const char *nameOfFileSent, bool zip, FilePosition length, time_t lastModified) noexcept;
+	FileStore *OpenWebFile(const char *nameOfFile, bool zip) const noexcept;
+	time_t GetWebFileLastModified(const char *nameOfFile, bool zip) const noexcept;
+	bool IsNotModified(const char *etag) const noexcept;
+	void SendNotModified(const char *etag) noexcept;
+	RangeResult ParseRange(FilePosition fileLength, const char *etag, FilePosition& rangeStart) const noexcept;
+
+	static const char *GetResolvedName(const WebFileCacheEntry& entry) noexcept;
+	static void MakeETag(const StringRef& etag, FilePosition length, time_t lastModified) noexcept;
 #endif
 
 	const char* GetKeyValue(const char *key) const noexcept;	// return the value of the specified key, or nullptr if not present
+	const char* GetHeaderValue(const char *key) const noexcept;	// return the value of the specified header, or nullptr if not present
 
 	static void RemoveSession(size_t sessionToRemove) noexcept;
 
@@ -118,6 +169,12 @@ private:
 	uint32_t startedProcessingRequestAt;			// when we started processing the current HTTP request
 	// rr_fileinfo also uses fileBeingProcessed in the networkResponder class
 
+	// rr_model requests that wait for the object model to change
+	uint32_t modelSeqWaitedFor;						// the object model sequence number that the client already has
+	uint32_t modelWaitTimeout;						// how long to hold the request if nothing changes
+	uint32_t modelMinInterval;						// how long to hold the request even if something changes, to limit the rate of responses
+	bool modelWaitFinished;							// true when we have finished waiting and need to send the response
+
 	uint32_t postFileLength;
 	uint32_t postFileExpectedCrc;
 	time_t fileLastModified;
@@ -127,6 +184,17 @@ private:
 	static HttpSession sessions[MaxHttpSessions];
 	static unsigned int numSessions;
 	static unsigned int clientsServed;
+	static unsigned int numKeepAliveRequests;		// how many times we reused a persistent connection for another request
+#if SUPPORT_OBJECT_MODEL
+	static size_t numModelWaiters;					// how many responders are holding rr_model requests until the object model changes
+#endif
+
+#if HAS_MASS_STORAGE
+	// Web file cache, only accessed by the Network task
+	static WebFileCacheEntry webFileCache[NumWebFileCacheEntries];
+	static uint16_t webFileCacheSeq;				// the sequence number of the web file volume when the cache entries were valid
+	static unsigned int numNotModifiedResponses;
+#endif
 
 	// Responses from GCodes class
 	static volatile uint16_t seq;					// Sequence number for G-Code replies
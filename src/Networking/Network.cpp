@@ -512,19 +512,22 @@ void Network::Spin() noexcept
 		}
 
 #if HAS_RESPONDERS
-		// Poll the responders
-		NetworkResponder *nr = nextResponderToPoll;
-		bool doneSomething = false;
+		// Poll the responders. Each responder does a bounded amount of work per call (e.g. a file transfer sends at most one
+		// network buffer), so we give every responder a turn on each pass. This interleaves long file transfers with short
+		// requests such as rr_model, instead of making the short requests wait behind the transfers.
+		// We rotate the starting point so that no responder is consistently favoured.
+		NetworkResponder * const firstResponder = (nextResponderToPoll == nullptr) ? responders : nextResponderToPoll;		// 'responders' can't be null at this point
+		NetworkResponder *nr = firstResponder;
 		do
 		{
+			(void)nr->Spin();
+			nr = nr->GetNext();
 			if (nr == nullptr)
 			{
-				nr = responders;		// 'responders' can't be null at this point
+				nr = responders;
 			}
-			doneSomething = nr->Spin();
-			nr = nr->GetNext();
-		} while (!doneSomething && nr != nextResponderToPoll);
-		nextResponderToPoll = nr;
+		} while (nr != firstResponder);
+		nextResponderToPoll = firstResponder->GetNext();
 #endif
 
 #if SUPPORT_HTTP
@@ -571,6 +574,7 @@ void Network::Diagnostics(MessageType mtype) noexcept
 	for (NetworkInterface *iface : interfaces)
 	{
 		iface->Diagnostics(mtype);
+		iface->UploadDiagnostics(mtype);
 	}
 #endif
 }
@@ -7,6 +7,7 @@
 
 #include "NetworkInterface.h"
 #include <Platform/RepRap.h>
+#include <Platform/Platform.h>
 
 void NetworkInterface::SetState(NetworkState::RawType newState) noexcept
 {
@@ -14,4 +15,30 @@ void NetworkInterface::SetState(NetworkState::RawType newState) noexcept
 	reprap.NetworkUpdated();
 }
 
+// Record the size and duration of a completed upload on this interface
+void NetworkInterface::RecordUpload(uint32_t numBytes, uint32_t elapsedMillis) noexcept
+{
+	uploadedBytes += numBytes;
+	uploadMillis += elapsedMillis;
+	const float rate = (float)numBytes/(float)max<uint32_t>(elapsedMillis, 1);
+	if (rate > fastestUploadRate)
+	{
+		fastestUploadRate = rate;
+	}
+}
+
+// Report the upload speed on this interface since the last report
+void NetworkInterface::UploadDiagnostics(MessageType mtype) noexcept
+{
+	if (uploadMillis != 0)
+	{
+		// The rates are in bytes per millisecond, so multiply by 1000 to get bytes per second
+		const float averageRate = (float)uploadedBytes/(float)uploadMillis * 1000.0f;
+		reprap.GetPlatform().MessageF(mtype, "Uploaded %" PRIu32 " bytes at average %.0f bytes/sec, fastest %.0f bytes/sec\n",
+										uploadedBytes, (double)averageRate, (double)(fastestUploadRate * 1000.0f));
+	}
+	uploadedBytes = uploadMillis = 0;
+	fastestUploadRate = 0.0;
+}
+
 // End
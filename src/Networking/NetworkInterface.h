@@ -44,6 +44,9 @@ public:
 	virtual void OpenDataPort(TcpPort port) noexcept = 0;
 	virtual void TerminateDataPort() noexcept = 0;
 
+	void RecordUpload(uint32_t numBytes, uint32_t elapsedMillis) noexcept;
+	void UploadDiagnostics(MessageType mtype) noexcept;
+
 	Mutex interfaceMutex;							// mutex to protect against multiple tasks using the same interface concurrently. Public so that sockets can lock it.
 
 protected:
@@ -56,6 +59,12 @@ protected:
 
 private:
 	NetworkState state;
+
+	// Upload statistics since the last diagnostics report
+	uint32_t uploadedBytes = 0;
+	uint32_t uploadMillis = 0;
+	float fastestUploadRate = 0.0;					// in bytes per millisecond, i.e. KB/sec
+
 };
 
 #endif /* SRC_NETWORKING_NETWORKINTERFACE_H_ */
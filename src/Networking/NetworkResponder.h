@@ -44,6 +44,7 @@ protected:
 		// HTTP responder additional states
 		processingRequest,
 		gettingFileInfo,								// getting file info
+		waitingForModelChange,							// holding an rr_model request until the object model changes
 
 		// FTP responder additional states
 		waitingForPasvPort,
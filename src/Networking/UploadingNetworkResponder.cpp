@@ -7,6 +7,7 @@
 
 #include "UploadingNetworkResponder.h"
 #include "Socket.h"
+#include "NetworkInterface.h"
 #include <Platform/Platform.h>
 
 unsigned UploadingNetworkResponder::numUploads = 0;
@@ -75,6 +76,38 @@ bool UploadingNetworkResponder::StartUpload(const char* folder, const char *file
 	}
 	responderState = ResponderState::uploading;
 	uploadError = false;
+	uploadedBytes = 0;
+	uploadStartTime = millis();
+	return true;
+}
+
+// Continue writing to an existing file from the specified offset, discarding any data after that offset, returning true if successful.
+// The data is written to the file directly rather than to a temporary file, so if the upload fails then the data received so far is kept and the client can resume it again.
+bool UploadingNetworkResponder::ResumeUpload(const char* folder, const char *fileName, FilePosition offset) noexcept
+{
+	filenameBeingProcessed.Clear();										// we don't rename or delete the file when we finish
+	String<MaxFilenameLength> location;
+	if (!MassStorage::CombineName(location.GetRef(), folder, fileName) || !MassStorage::FileExists(location.c_str()))
+	{
+		return false;
+	}
+
+	FileStore * const file = GetPlatform().OpenFile(folder, fileName, OpenMode::append);
+	if (file == nullptr)
+	{
+		return false;
+	}
+	if (file->Length() < offset || !file->Seek(offset) || !file->Truncate())
+	{
+		file->Close();
+		return false;
+	}
+	fileBeingUploaded.Set(file);
+	dummyUpload = false;
+	responderState = ResponderState::uploading;
+	uploadError = false;
+	uploadedBytes = 0;
+	uploadStartTime = millis();
 	return true;
 }
 
@@ -83,6 +116,7 @@ void UploadingNetworkResponder::FinishUpload(uint32_t fileLength, time_t fileLas
 {
 	numUploads++;
 	skt->SetResponder(nullptr);
+	skt->GetInterface()->RecordUpload(uploadedBytes, millis() - uploadStartTime);
 	if (!dummyUpload)
 	{
 		// Flush remaining data for FSO
@@ -20,11 +20,13 @@ protected:
 
 #if HAS_MASS_STORAGE
 	bool StartUpload(const char* folder, const char *fileName, const OpenMode mode, const uint32_t preAllocSize = 0) noexcept;
+	bool ResumeUpload(const char* folder, const char *fileName, FilePosition offset) noexcept;
 	void FinishUpload(uint32_t fileLength, time_t fileLastModified, bool gotCrc, uint32_t expectedCrc) noexcept;
 
 	// File uploads
 	FileData fileBeingUploaded;
 	uint32_t uploadedBytes;								// how many bytes have already been written
+	uint32_t uploadStartTime;							// when we started the upload, for reporting the upload speed
 	bool uploadError;
 	bool dummyUpload;
 	static unsigned numUploads;
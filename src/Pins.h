@@ -64,6 +64,14 @@
 # define SUPPORT_LED_STRIPS		0
 #endif
 
+#ifndef SD_READ_CACHE_LINES
+# define SD_READ_CACHE_LINES		0		// number of lines in the SD card read-ahead cache used by the LPC and STM32 disk I/O layer
+#endif
+
+#ifndef SUPPORT_HEATER_SIMULATION
+# define SUPPORT_HEATER_SIMULATION	0		// simulated heater sensors for testing heater control; define as 1 on the compiler command line in development builds only
+#endif
+
 #define HAS_AUX_DEVICES			(defined(SERIAL_AUX_DEVICE))		// if SERIAL_AUX_DEVICE is defined then we have one or more aux devices
 
 #ifndef ALLOW_ARBITRARY_PANELDUE_PORT
@@ -25,21 +25,49 @@ private:
 	bool& b;
 };
 
-Logger::Logger(LogLevel logLvl) noexcept : logFile(), lastFlushTime(0), lastFlushFileSize(0), dirty(false), inLogger(false), logLevel(logLvl)
+Logger::Logger(LogLevel logLvl) noexcept : logFile(), lastFlushTime(0), flushInterval(LogFlushInterval), clusterSize(512), lastFlushFileSize(0), dirty(false), inLogger(false), logLevel(logLvl), binary(false),
+	  ringBuffer(nullptr), ringHead(0), ringTail(0), lostMessages(0)
 {
 }
 
-void Logger::Start(time_t time, const StringRef& filename) noexcept
+GCodeResult Logger::Start(time_t time, const StringRef& filename, bool useBinary, const StringRef& reply) noexcept
 {
 	if (!inLogger && logLevel > LogLevel::off)
 	{
 		Lock loggerLock(inLogger);
+
+		// Never append records in one format to a log file written in the other, because then neither the decoder nor a text viewer could read it
+		bool existingIsBinary;
+		if (GetExistingFileFormat(filename.c_str(), existingIsBinary) && existingIsBinary != useBinary)
+		{
+			reply.printf("Log file %s is in %s format, so it can't be used for %s logging", filename.c_str(),
+							(existingIsBinary) ? "binary" : "text", (useBinary) ? "binary" : "text");
+			return GCodeResult::error;
+		}
+
 		FileStore * const f = reprap.GetPlatform().OpenSysFile(filename.c_str(), OpenMode::append);
 		if (f != nullptr)
 		{
+			// The ring buffer is never freed once allocated, because another task may be queuing a message in it
+			if (useBinary && ringBuffer == nullptr)
+			{
+				ringBuffer = new char[LogRingBufferSize];
+			}
+			{
+				TaskCriticalSectionLocker lock;
+				ringHead = ringTail = 0;
+				lostMessages = 0;
+				binary = useBinary;
+			}
+
 			logFile.Set(f);
+			clusterSize = max<uint32_t>(logFile.ClusterSize(), 512);
 			lastFlushFileSize = logFile.Length();
 			logFile.Seek(lastFlushFileSize);
+			if (binary && lastFlushFileSize == 0)
+			{
+				logFile.Write(BinaryLogFileHeader, strlen(BinaryLogFileHeader));
+			}
 			logFileName.copy(filename.c_str());
 			String<StringLength50> startMessage;
 			startMessage.printf("Event logging started at level %s\n", logLevel.ToString());
@@ -48,6 +76,26 @@ void Logger::Start(time_t time, const StringRef& filename) noexcept
 			reprap.StateUpdated();
 		}
 	}
+	return GCodeResult::ok;
+}
+
+// If the log file already exists and isn't empty, find out whether it is a binary log and return true
+/*static*/ bool Logger::GetExistingFileFormat(const char *filename, bool& isBinary) noexcept
+{
+	FileStore * const f = reprap.GetPlatform().OpenSysFile(filename, OpenMode::read);
+	if (f == nullptr)
+	{
+		return false;
+	}
+	char header[sizeof(BinaryLogFileHeader) - 1];
+	const int bytesRead = f->Read(header, sizeof(header));
+	f->Close();
+	if (bytesRead <= 0)
+	{
+		return false;
+	}
+	isBinary = (bytesRead == (int)sizeof(header) && memcmp(header, BinaryLogFileHeader, sizeof(header)) == 0);
+	return true;
 }
 
 // TODO: Move this to a more sensible location ?
@@ -78,6 +126,10 @@ void Logger::Stop(time_t time) noexcept
 	{
 		Lock loggerLock(inLogger);
 		InternalLogMessage(time, "Event logging stopped\n", MessageLogLevel::info);
+		if (binary)
+		{
+			(void)DrainRingBuffer();
+		}
 		logFile.Close();
 		reprap.StateUpdated();
 	}
@@ -101,16 +153,22 @@ bool Logger::IsLoggingEnabledFor(const MessageType mt) const noexcept
 }
 #endif
 
+// In binary mode messages are only queued, so we don't need to check inLogger
 void Logger::LogMessage(time_t time, const char *message, MessageType type) noexcept
 {
 
-	if (logFile.IsLive() && !inLogger && !IsEmptyMessage(message))
+	if (logFile.IsLive() && (binary || !inLogger) && !IsEmptyMessage(message))
 	{
 		const auto messageLogLevel = GetMessageLogLevel(type);
 		if (!IsLoggingEnabledFor(messageLogLevel))
 		{
 			return;
 		}
+		if (binary)
+		{
+			QueueRecord(time, message, strlen(message), messageLogLevel);
+			return;
+		}
 		Lock loggerLock(inLogger);
 		InternalLogMessage(time, message, messageLogLevel);
 	}
@@ -118,13 +176,18 @@ void Logger::LogMessage(time_t time, const char *message, MessageType type) noex
 
 void Logger::LogMessage(time_t time, OutputBuffer *buf, MessageType type) noexcept
 {
-	if (logFile.IsLive() && !inLogger && !IsEmptyMessage(buf->Data()))
+	if (logFile.IsLive() && (binary || !inLogger) && !IsEmptyMessage(buf->Data()))
 	{
 		const auto messageLogLevel = GetMessageLogLevel(type);
 		if (!IsLoggingEnabledFor(messageLogLevel))
 		{
 			return;
 		}
+		if (binary)
+		{
+			QueueRecord(time, buf, messageLogLevel);
+			return;
+		}
 		Lock loggerLock(inLogger);
 		bool ok = WriteDateTimeAndLogLevelPrefix(time, messageLogLevel);
 		if (ok)
@@ -147,6 +210,12 @@ void Logger::LogMessage(time_t time, OutputBuffer *buf, MessageType type) noexce
 // Version of LogMessage for when we already know we want to proceed and we have already set inLogger
 void Logger::InternalLogMessage(time_t time, const char *message, const MessageLogLevel messageLogLevel) noexcept
 {
+	if (binary)
+	{
+		QueueRecord(time, message, strlen(message), messageLogLevel);
+		return;
+	}
+
 	bool ok = WriteDateTimeAndLogLevelPrefix(time, messageLogLevel);
 	if (ok)
 	{
@@ -175,16 +244,27 @@ void Logger::InternalLogMessage(time_t time, const char *message, const MessageL
 // This is called regularly by Platform to give the logger an opportunity to flush the file buffer
 void Logger::Flush(bool forced) noexcept
 {
+	if (logFile.IsLive() && binary && ringHead != ringTail && !inLogger)
+	{
+		Lock loggerLock(inLogger);
+		if (!DrainRingBuffer())
+		{
+			logFile.Close();
+			reprap.StateUpdated();
+			return;
+		}
+	}
+
 	if (logFile.IsLive() && dirty && !inLogger)
 	{
 		// Log file is dirty and can be flushed.
-		// To avoid excessive disk write operations, flush it only if one of the following is true:
-		// 1. We have possibly allocated a new cluster since the last flush. To avoid lost clusters if we power down before flushing,
-		//    we should flush early in this case. Rather than determine the cluster size, we flush if we have started a new 512-byte sector.
-		// 2. If it hasn't been flushed for LogFlushInterval milliseconds.
+		// Flushing updates the FAT and the directory entry as well as writing the data, so to avoid excessive disk write operations, flush it only if one of the following is true:
+		// 1. We have allocated a new cluster since the last flush. To avoid lost clusters if we power down before flushing, we should flush early in this case.
+		//    Until we start a new cluster, the data we write only changes the last data sector of the file, which FatFS writes when it moves on to the next sector.
+		// 2. If it hasn't been flushed for flushInterval milliseconds.
 		const FilePosition currentPos = logFile.GetPosition();
 		const uint32_t now = millis();
-		if (forced || now - lastFlushTime >= LogFlushInterval || currentPos/512 != lastFlushFileSize/512)
+		if (forced || now - lastFlushTime >= flushInterval || currentPos/clusterSize != lastFlushFileSize/clusterSize)
 		{
 			Lock loggerLock(inLogger);
 			logFile.Flush();
@@ -217,6 +297,130 @@ bool Logger::WriteDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel message
 	return logFile.Write(buf.c_str());
 }
 
+// Queue a binary log record. A trailing newline is not stored because the decoder adds one to every record.
+// If there isn't room for the whole record then it is discarded and counted, so that the file never contains a partial record.
+void Logger::QueueRecord(time_t time, const char *text, size_t length, MessageLogLevel messageLogLevel) noexcept
+{
+	if (length != 0 && text[length - 1] == '\n')
+	{
+		--length;
+	}
+	length = min<size_t>(length, UINT16_MAX);
+
+	TaskCriticalSectionLocker lock;
+	if (RingBufferSpace() < sizeof(LogRecordHeader) + length)
+	{
+		++lostMessages;
+	}
+	else
+	{
+		QueueRecordHeader(time, length, messageLogLevel);
+		QueueBytes(text, length);
+	}
+}
+
+// Queue a binary log record whose text is held in a chain of output buffers
+void Logger::QueueRecord(time_t time, const OutputBuffer *buf, MessageLogLevel messageLogLevel) noexcept
+{
+	size_t length = 0;
+	const OutputBuffer *lastBuf = nullptr;
+	for (const OutputBuffer *b = buf; b != nullptr; b = b->Next())
+	{
+		length += b->DataLength();
+		if (b->DataLength() != 0)
+		{
+			lastBuf = b;
+		}
+	}
+	const bool trailingNewline = lastBuf != nullptr && lastBuf->Data()[lastBuf->DataLength() - 1] == '\n';
+	if (trailingNewline)
+	{
+		--length;
+	}
+	length = min<size_t>(length, UINT16_MAX);
+
+	TaskCriticalSectionLocker lock;
+	if (RingBufferSpace() < sizeof(LogRecordHeader) + length)
+	{
+		++lostMessages;
+	}
+	else
+	{
+		QueueRecordHeader(time, length, messageLogLevel);
+		size_t remaining = length;
+		for (const OutputBuffer *b = buf; b != nullptr && remaining != 0; b = b->Next())
+		{
+			const size_t toCopy = min<size_t>(b->DataLength(), remaining);
+			QueueBytes(b->Data(), toCopy);
+			remaining -= toCopy;
+		}
+	}
+}
+
+// Queue a binary record header. Caller must have checked that there is room for it and must hold the task critical section.
+void Logger::QueueRecordHeader(time_t time, size_t length, MessageLogLevel messageLogLevel) noexcept
+{
+	LogRecordHeader hdr;
+	hdr.marker = LogRecordMarker;
+	hdr.level = messageLogLevel.ToBaseType();
+	hdr.length = (uint16_t)length;
+	hdr.time = (uint32_t)time;
+	hdr.millis = millis();
+	QueueBytes(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+}
+
+// Copy data into the ring buffer. Caller must have checked that there is room for it and must hold the task critical section.
+void Logger::QueueBytes(const char *data, size_t length) noexcept
+{
+	size_t head = ringHead;
+	while (length != 0)
+	{
+		const size_t chunk = min<size_t>(length, LogRingBufferSize - head);
+		memcpy(ringBuffer + head, data, chunk);
+		data += chunk;
+		length -= chunk;
+		head = (head + chunk) % LogRingBufferSize;
+	}
+	ringHead = head;
+}
+
+// Write queued binary records to the log file. Called only from the main task with inLogger set, so the file is not accessed concurrently.
+// The ring buffer is not locked while we write the file, because other tasks only ever add data beyond ringHead.
+bool Logger::DrainRingBuffer() noexcept
+{
+	size_t tail = ringTail;
+	for (;;)
+	{
+		const size_t head = ringHead;
+		if (head == tail)
+		{
+			break;
+		}
+		const size_t chunk = (head > tail) ? head - tail : LogRingBufferSize - tail;
+		if (!logFile.Write(ringBuffer + tail, chunk))
+		{
+			return false;
+		}
+		tail = (tail + chunk) % LogRingBufferSize;
+		ringTail = tail;
+		dirty = true;
+	}
+
+	if (lostMessages != 0)
+	{
+		uint32_t numLost;
+		{
+			TaskCriticalSectionLocker lock;
+			numLost = lostMessages;
+			lostMessages = 0;
+		}
+		String<StringLength50> lostMessage;
+		lostMessage.printf("%" PRIu32 " log messages lost because the log buffer was full", numLost);
+		QueueRecord(reprap.GetPlatform().GetDateTime(), lostMessage.c_str(), lostMessage.strlen(), MessageLogLevel::warn);
+	}
+	return true;
+}
+
 #endif
 
 // End
@@ -24,15 +24,18 @@ class Logger
 public:
 	Logger(LogLevel logLvl) noexcept;
 
-	void Start(time_t time, const StringRef& file) noexcept;
+	GCodeResult Start(time_t time, const StringRef& file, bool binary, const StringRef& reply) noexcept;
 	void Stop(time_t time) noexcept;
 	void LogMessage(time_t time, const char *message, MessageType type) noexcept;
 	void LogMessage(time_t time, OutputBuffer *buf, MessageType type) noexcept;
 	void Flush(bool forced) noexcept;
 	bool IsActive() const noexcept { return logFile.IsLive(); }
+	bool IsBinary() const noexcept { return binary; }
 	const char *GetFileName() const noexcept { return (IsActive()) ? logFileName.c_str() : nullptr; }
 	LogLevel GetLogLevel() const noexcept { return logLevel; }
 	void SetLogLevel(LogLevel newLogLevel) noexcept;
+	uint32_t GetFlushInterval() const noexcept { return flushInterval; }
+	void SetFlushInterval(uint32_t ms) noexcept { flushInterval = ms; }
 #if 0 // Currently not needed but might be useful in the future
 	bool IsLoggingEnabledFor(const MessageType mt) const noexcept;
 	bool IsWarnEnabled() const noexcept { return logLevel >= LogLevel::warn; }
@@ -52,13 +55,44 @@ private:
 	void LogFirmwareInfo(time_t time) noexcept;
 	bool IsEmptyMessage(const char * message) const noexcept { return message[0] == '\0' || (message[0] == '\n' && message[1] == '\0'); }
 
+	// Binary log support. Each record is a LogRecordHeader followed by the message text, without a terminating null or newline.
+	// Records are queued in a ring buffer by whichever task logs the message, and written to the file by Flush, which is called from the main task.
+	struct LogRecordHeader
+	{
+		uint8_t marker;						// always LogRecordMarker, so that the decoder can resynchronise after a corrupt record
+		uint8_t level;						// the MessageLogLevel
+		uint16_t length;					// number of bytes of message text following the header
+		uint32_t time;						// real time in seconds since 1970, or zero if the time has not been set
+		uint32_t millis;					// milliseconds since power up
+	};
+	static_assert(sizeof(LogRecordHeader) == 12);
+
+	static constexpr uint8_t LogRecordMarker = 0xA5;
+	static constexpr char BinaryLogFileHeader[] = "RRFLOG1\n";
+
+	static bool GetExistingFileFormat(const char *filename, bool& isBinary) noexcept;
+	void QueueRecord(time_t time, const char *text, size_t length, MessageLogLevel messageLogLevel) noexcept;
+	void QueueRecord(time_t time, const OutputBuffer *buf, MessageLogLevel messageLogLevel) noexcept;
+	void QueueRecordHeader(time_t time, size_t length, MessageLogLevel messageLogLevel) noexcept;
+	void QueueBytes(const char *data, size_t length) noexcept;
+	size_t RingBufferSpace() const noexcept { return (ringTail + LogRingBufferSize - ringHead - 1) % LogRingBufferSize; }
+	bool DrainRingBuffer() noexcept;
+
 	String<MaxFilenameLength> logFileName;
 	FileData logFile;
 	uint32_t lastFlushTime;
+	uint32_t flushInterval;					// the maximum time in milliseconds that we leave unflushed data in the log file
+	uint32_t clusterSize;					// the cluster size of the volume that the log file is on
 	FilePosition lastFlushFileSize;
 	bool dirty;
 	bool inLogger;
 	LogLevel logLevel;
+	bool binary;							// true if we are writing the log file in binary format
+
+	char *ringBuffer;						// the binary log ring buffer, allocated the first time binary logging is started
+	volatile size_t ringHead;				// where the next record will be queued
+	volatile size_t ringTail;				// the next byte to be written to the file
+	uint32_t lostMessages;					// number of messages discarded because the ring buffer was full
 };
 
 #endif
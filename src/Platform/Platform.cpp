@@ -2490,24 +2490,32 @@ GCodeResult Platform::DiagnosticTest(GCodeBuffer& gb, const StringRef& reply, Ou
 	case (unsigned int)DiagnosticTestType::TimeCRC32:
 		{
 			const size_t length = (gb.Seen('S')) ? gb.GetUIValue() : 1024;
+#if SAME5x
+			const char * const data = reinterpret_cast<const char*>(HSRAM_ADDR);
+#else
+			const char * const data = reinterpret_cast<const char*>(IRAM_ADDR);		// for the SAME70 this is in the non-cacheable RAM, which is the usual case when computing a CRC
+#endif
 			CRC32 crc;
 			IrqDisable();
 			asm volatile("":::"memory");
 			uint32_t now1 = SysTick->VAL;
-			crc.Update(
-#if SAME5x
-						reinterpret_cast<const char*>(HSRAM_ADDR),
-#else
-						reinterpret_cast<const char*>(IRAM_ADDR),		// for the SAME70 this is in the non-cacheable RAM, which is the usual case when computing a CRC
-#endif
-						length);
+			crc.Update(data, length);
 			uint32_t now2 = SysTick->VAL;
 			asm volatile("":::"memory");
 			IrqEnable();
 			now1 &= 0x00FFFFFF;
 			now2 &= 0x00FFFFFF;
 			uint32_t tim1 = ((now1 > now2) ? now1 : now1 + (SysTick->LOAD & 0x00FFFFFF) + 1) - now2;
-			reply.printf("CRC of %u bytes took %.2fus", length, (double)((1'000'000.0f * (float)tim1)/(float)SystemCoreClock));
+			const float microseconds = (1'000'000.0f * (float)tim1)/(float)SystemCoreClock;
+
+			// Check the result against the simple bytewise algorithm
+			CRC32 checkCrc;
+			for (size_t i = 0; i < length; ++i)
+			{
+				checkCrc.Update(data[i]);
+			}
+			reply.printf("CRC of %u bytes took %.2fus (%.1fMB/s), result %s",
+							length, (double)microseconds, (microseconds == 0.0f) ? 0.0 : (double)((float)length/microseconds), (crc.Get() == checkCrc.Get()) ? "ok" : "INCORRECT");
 		}
 		break;
 
@@ -3767,18 +3775,23 @@ GCodeResult Platform::ConfigureLogging(GCodeBuffer& gb, const StringRef& reply)
 			{
 				logger->SetLogLevel(logLevel);
 			}
+			if (gb.Seen('F'))
+			{
+				logger->SetFlushInterval(gb.GetLimitedUIValue('F', 1, 3601) * 1000);
+			}
 
 			char buf[MaxFilenameLength + 1];
 			StringRef filename(buf, ARRAY_SIZE(buf));
+			const bool binary = gb.Seen('B') && gb.GetUIValue() != 0;
 			if (gb.Seen('P'))
 			{
 				gb.GetQuotedString(filename);
 			}
 			else
 			{
-				filename.copy(DEFAULT_LOG_FILE);
+				filename.copy((binary) ? DEFAULT_BINARY_LOG_FILE : DEFAULT_LOG_FILE);
 			}
-			logger->Start(realTime, filename);
+			return logger->Start(realTime, filename, binary, reply);
 		}
 	}
 	else
@@ -3790,7 +3803,8 @@ GCodeResult Platform::ConfigureLogging(GCodeBuffer& gb, const StringRef& reply)
 		else
 		{
 			const auto logLevel = logger->GetLogLevel();
-			reply.printf("Event logging is enabled at log level %s", logLevel.ToString());
+			reply.printf("Event logging is enabled at log level %s in %s format, flush interval %" PRIu32 "s",
+							logLevel.ToString(), (logger->IsBinary()) ? "binary" : "text", logger->GetFlushInterval()/1000);
 		}
 	}
 	return GCodeResult::ok;
@@ -2421,6 +2421,86 @@ OutputBuffer *RepRap::GetModelResponse(const char *key, const char *flags) const
 	return outBuf;
 }
 
+// Append the response to one key of a batched object model request to buf, without the key and flags.
+// If the key is covered by a sequence number in the seqs section and that number still has the value the client already knows, report just the sequence number.
+void RepRap::AppendModelResponse(OutputBuffer *buf, const char *key, const char *flags, uint32_t lastSeq) const THROWS(GCodeException)
+{
+	const bool wantArrayLength = (*key == '#');
+	if (wantArrayLength)
+	{
+		++key;
+	}
+
+	uint32_t seq;
+	if (GetKeySeq(key, seq))
+	{
+		buf->catf("{\"seq\":%" PRIu32, seq);
+		if (seq == lastSeq)
+		{
+			buf->cat('}');
+			return;
+		}
+		buf->cat(",\"result\":");
+	}
+	else
+	{
+		buf->cat("{\"result\":");
+	}
+	reprap.ReportAsJson(buf, key, flags, wantArrayLength);
+	buf->cat('}');
+}
+
+// Get the sequence number in the seqs section that covers the top-level object model key that the given key starts with.
+// Return false if there isn't one, e.g. because the key refers to values that never change.
+bool RepRap::GetKeySeq(const char *key, uint32_t& seq) const noexcept
+{
+	static const struct { const char *name; uint16_t RepRap::*seq; } keySeqs[] =
+	{
+		{ "boards", &RepRap::boardsSeq },
+		{ "directories", &RepRap::directoriesSeq },
+		{ "fans", &RepRap::fansSeq },
+		{ "global", &RepRap::globalSeq },
+		{ "heat", &RepRap::heatSeq },
+		{ "inputs", &RepRap::inputsSeq },
+		{ "job", &RepRap::jobSeq },
+		{ "move", &RepRap::moveSeq },
+		{ "network", &RepRap::networkSeq },
+		{ "scanner", &RepRap::scannerSeq },
+		{ "sensors", &RepRap::sensorsSeq },
+		{ "spindles", &RepRap::spindlesSeq },
+		{ "state", &RepRap::stateSeq },
+		{ "tools", &RepRap::toolsSeq },
+		{ "volumes", &RepRap::volumesSeq },
+	};
+
+	const size_t keyLength = strcspn(key, ".[");
+	for (const auto& ks : keySeqs)
+	{
+		if (strlen(ks.name) == keyLength && strncmp(ks.name, key, keyLength) == 0)
+		{
+			seq = this->*ks.seq;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Return a value that changes whenever any of the sequence numbers in the seqs section of the object model changes.
+// Network clients can use this to wait for the object model to change instead of polling it repeatedly.
+uint32_t RepRap::GetModelSeq() const noexcept
+{
+	uint32_t modelSeq = (uint32_t)boardsSeq + directoriesSeq + fansSeq + globalSeq + heatSeq + inputsSeq + jobSeq + moveSeq
+					  + networkSeq + scannerSeq + sensorsSeq + spindlesSeq + stateSeq + toolsSeq + volumesSeq + mbox.seq
+					  + network->GetHttpReplySeq();
+#if HAS_MASS_STORAGE
+	for (unsigned int vol = 0; vol < NumSdCards; ++vol)
+	{
+		modelSeq += MassStorage::GetVolumeSeq(vol);
+	}
+#endif
+	return modelSeq;
+}
+
 #endif
 
 // Send a beep. We send it to both PanelDue and the web interface.
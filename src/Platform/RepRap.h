@@ -154,6 +154,9 @@ public:
 
 #if SUPPORT_OBJECT_MODEL
 	OutputBuffer *GetModelResponse(const char *key, const char *flags) const THROWS(GCodeException);
+	void AppendModelResponse(OutputBuffer *buf, const char *key, const char *flags, uint32_t lastSeq) const THROWS(GCodeException);
+	uint32_t GetModelSeq() const noexcept;
+	bool GetKeySeq(const char *key, uint32_t& seq) const noexcept;
 #endif
 
 	void Beep(unsigned int freq, unsigned int ms) noexcept;
@@ -113,6 +113,11 @@ public:
 		return f->Length();
 	}
 
+	uint32_t ClusterSize() const noexcept
+	{
+		return f->ClusterSize();
+	}
+
 	// Move operator
 	void MoveFrom(FileData& other) noexcept
 	{
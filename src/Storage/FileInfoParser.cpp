@@ -11,19 +11,87 @@
 #include <Platform/Platform.h>
 #include <PrintMonitor/PrintMonitor.h>
 #include <GCodes/GCodes.h>
+#include "CRC32.h"
 
 #if HAS_MASS_STORAGE
 
+// The strings we look for in the file. The Find functions search only for these, so that the keyword scanner knows about all of them.
+constexpr const char* LayerHeightStrings[] =
+{
+	"layer_height",			// slic3r
+	"Layer height",			// Cura
+	"layerHeight",			// S3D
+	"layer_thickness_mm",	// Kisslicer
+	"layerThickness",		// Matter Control
+	"sliceHeight"			// kiri:moto
+};
+
+constexpr const char* GeneratedByStrings[] =
+{
+	"; KISSlicer",		// KISSlicer
+	";Sliced at: ",		// Cura (old)
+	";Fusion version:",	// Fusion 360
+	"generated by ",	// slic3r and S3D
+	";Sliced by ",		// ideaMaker
+	";Generated with ",	// Cura (new)
+	"; Generated by ",	// kiri:moto
+	";GENERATOR.NAME:",	// Pathio (the version is separate, we don't include that)
+	"; Generated with "	// Matter Control
+};
+
+constexpr const char* PrintTimeStrings[] =
+{
+	// Note: if a string in this table is a leading or embedded substring of another, the longer one must come first
+	" estimated printing time (normal mode)",	// slic3r PE later versions	"; estimated printing time (normal mode) = 1h 5m 24s"
+	" estimated printing time",					// slic3r PE older versions	"; estimated printing time = 1h 5m 24s"
+	";TIME",									// Cura						";TIME:38846"
+	" Build time",								// S3D						";   Build time: 0 hours 42 minutes"
+	" Build Time",								// KISSlicer				"; Estimated Build Time:   332.83 minutes"
+												// also KISSSlicer 2 alpha	"; Calculated-during-export Build Time: 130.62 minutes"
+	";Print Time:",								// Ideamaker
+	";PRINT.TIME:",								// Patio
+	";Print time:",								// Fusion 360
+	"; total print time (s) ="					// Matter Control
+};
+
+constexpr char FilamentUsedString[] = "ilament used";							// comment string used by slic3r and Cura, followed by filament used and "mm"
+constexpr char IdeamakerFilamentString[] = ";Material#";							// Ideamaker, e.g. ";Material#1 Used: 868.0"
+constexpr char FusionFilamentString[] = ";Extruder ";							// Fusion 360, e.g. ";Extruder 1 material used: 1811mm"
+constexpr char S3DFilamentString[] = "ilament length";							// comment string used by S3D
+constexpr char KISSlicerFilamentString[] = ";    Ext ";						// recent KISSlicer versions
+constexpr char KISSlicerVolumeString[] = "; Estimated Build Volume: ";			// old KISSlicer
+constexpr char PathioVolumeString[] = ";EXTRUDER_TRAIN.0.MATERIAL.VOLUME_USED:";	// Pathio
+
+constexpr const char* FilamentStrings[] =
+{
+	FilamentUsedString, IdeamakerFilamentString, FusionFilamentString, S3DFilamentString, KISSlicerFilamentString, KISSlicerVolumeString, PathioVolumeString
+};
+
 FileInfoParser::FileInfoParser() noexcept
-	: parseState(notParsing), fileBeingParsed(nullptr), accumulatedParseTime(0), accumulatedReadTime(0), accumulatedSeekTime(0), fileOverlapLength(0)
+	: parseState(notParsing), fileBeingParsed(nullptr), accumulatedParseTime(0), accumulatedReadTime(0), accumulatedSeekTime(0), fileOverlapLength(0),
+	  cacheHits(0), cacheMisses(0)
 {
 	parsedFileInfo.Init();
 	parserMutex.Create("FileInfoParser");
+	cacheMutex.Create("FileInfoCache");
+	for (FileInfoCacheEntry& entry : cache)
+	{
+		entry.lastUsed = 0;
+		entry.info.Init();
+	}
+	scannedBuffer = nullptr;
 }
 
 // This following method needs to be called repeatedly until it returns true - this may take a few runs
 GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept
 {
+	// If we parsed this file before and it hasn't changed since, we already have the answer.
+	// This doesn't need the parser, so we can answer it even if the parser is busy with another file.
+	if (FindCachedInfo(filePath, info))
+	{
+		return GCodeResult::ok;
+	}
+
 	MutexLocker lock(parserMutex, MAX_FILEINFO_PROCESS_TIME);
 	if (!lock)
 	{
@@ -84,6 +152,7 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 		{
 			fileBeingParsed->Close();
 			parsedFileInfo.incomplete = false;
+			AddCachedInfo(filePath, parsedFileInfo);
 			info = parsedFileInfo;
 			return GCodeResult::ok;
 		}
@@ -130,10 +199,12 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				accumulatedReadTime += now - startTime;
 				startTime = now;
 
+				ScanKeywords(buf, sizeToScan);
+
 				// Search for filament usage (Cura puts it at the beginning of a G-code file)
 				if (parsedFileInfo.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf);
+					parsedFileInfo.numFilaments = FindFilamentUsed();
 					headerInfoComplete &= (parsedFileInfo.numFilaments != 0);
 				}
 
@@ -152,13 +223,13 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				// Look for slicer program
 				if (parsedFileInfo.generatedBy.IsEmpty())
 				{
-					headerInfoComplete &= FindSlicerInfo(buf);
+					headerInfoComplete &= FindSlicerInfo();
 				}
 
 				// Look for print time
 				if (parsedFileInfo.printTime == 0)
 				{
-					headerInfoComplete &= FindPrintTime(buf);
+					headerInfoComplete &= FindPrintTime();
 				}
 
 				// Keep track of the time stats
@@ -256,12 +327,14 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				accumulatedReadTime += now - startTime;
 				startTime = now;
 
+				ScanKeywords(buf, sizeToScan);
+
 				bool footerInfoComplete = true;
 
 				// Search for filament used
 				if (parsedFileInfo.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf);
+					parsedFileInfo.numFilaments = FindFilamentUsed();
 					if (parsedFileInfo.numFilaments == 0)
 					{
 						footerInfoComplete = false;
@@ -289,7 +362,7 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				// Look for print time
 				if (parsedFileInfo.printTime == 0)
 				{
-					if (!FindPrintTime(buf) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
+					if (!FindPrintTime() && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
 					{
 						footerInfoComplete = false;
 					}
@@ -298,7 +371,7 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				// Look for simulated print time. It will always be right at the end of the file, so don't look too far back
 				if (parsedFileInfo.simulatedTime == 0)
 				{
-					if (!FindSimulatedTime(buf) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
+					if (!FindSimulatedTime() && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
 					{
 						footerInfoComplete = false;
 					}
@@ -319,6 +392,7 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 					parseState = notParsing;
 					fileBeingParsed->Close();
 					parsedFileInfo.incomplete = false;
+					AddCachedInfo(filePath, parsedFileInfo);
 					info = parsedFileInfo;
 					return GCodeResult::ok;
 				}
@@ -350,6 +424,165 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 	return GCodeResult::notFinished;
 }
 
+// Return the hash we use to identify a file path in the cache. FAT filenames are not case sensitive, so neither is the hash.
+/*static*/ uint32_t FileInfoParser::HashPath(const char *filePath) noexcept
+{
+	CRC32 crc;
+	while (*filePath != 0)
+	{
+		crc.Update((char)tolower(*filePath++));
+	}
+	return crc.Get();
+}
+
+// Look for the file in the cache, returning true and filling in 'info' if we found it and it hasn't been changed since we parsed it
+bool FileInfoParser::FindCachedInfo(const char *filePath, GCodeFileInfo& info) noexcept
+{
+	FilePosition fileSize;
+	time_t lastModified;
+	if (!MassStorage::GetFileSizeAndTime(filePath, fileSize, lastModified))
+	{
+		return false;											// the file doesn't exist or is a directory, so let the parser report it
+	}
+
+	const uint32_t pathHash = HashPath(filePath);
+	MutexLocker lock(cacheMutex);
+	for (FileInfoCacheEntry& entry : cache)
+	{
+		if (entry.info.isValid && entry.pathHash == pathHash && entry.info.fileSize == fileSize && entry.info.lastModifiedTime == lastModified)
+		{
+			entry.lastUsed = millis();
+			info = entry.info;
+			++cacheHits;
+			return true;
+		}
+	}
+	++cacheMisses;
+	return false;
+}
+
+// Store the complete information for a file in the cache, replacing any older entry for the same path or else the least recently used entry
+void FileInfoParser::AddCachedInfo(const char *filePath, const GCodeFileInfo& info) noexcept
+{
+	const uint32_t pathHash = HashPath(filePath);
+	const uint32_t now = millis();
+	MutexLocker lock(cacheMutex);
+	FileInfoCacheEntry *victim = &cache[0];
+	for (FileInfoCacheEntry& entry : cache)
+	{
+		if (entry.info.isValid && entry.pathHash == pathHash)
+		{
+			victim = &entry;									// the file has changed since we cached it, so replace the old entry
+			break;
+		}
+		if (victim->info.isValid && (!entry.info.isValid || now - entry.lastUsed > now - victim->lastUsed))
+		{
+			victim = &entry;
+		}
+	}
+	victim->pathHash = pathHash;
+	victim->lastUsed = now;
+	victim->info = info;
+}
+
+void FileInfoParser::InvalidateCache() noexcept
+{
+	MutexLocker lock(cacheMutex);
+	for (FileInfoCacheEntry& entry : cache)
+	{
+		entry.info.isValid = false;
+	}
+}
+
+void FileInfoParser::GetAndClearCacheStats(unsigned int& hits, unsigned int& misses) noexcept
+{
+	MutexLocker lock(cacheMutex);
+	hits = cacheHits;
+	misses = cacheMisses;
+	cacheHits = cacheMisses = 0;
+}
+
+// Tables used by the keyword scanner. The constructor is evaluated at compile time, so the tables live in flash.
+struct FileInfoParser::KeywordTables
+{
+	const char *keywords[NumKeywords] = { };		// all the strings we look for
+	uint8_t firstKeyword[128] = { };				// for each ASCII character, the index of the first keyword that starts with it, or NoKeyword
+	uint8_t nextKeyword[NumKeywords] = { };			// for each keyword, the index of the next one that starts with the same character, or NoKeyword
+
+	constexpr KeywordTables() noexcept
+	{
+		static_assert(ARRAY_SIZE(LayerHeightStrings) + ARRAY_SIZE(GeneratedByStrings) + ARRAY_SIZE(PrintTimeStrings) + ARRAY_SIZE(FilamentStrings) + 1 == NumKeywords,
+						"NumKeywords is wrong");
+
+		size_t n = 0;
+		for (const char *kw : LayerHeightStrings) { keywords[n++] = kw; }
+		for (const char *kw : GeneratedByStrings) { keywords[n++] = kw; }
+		for (const char *kw : PrintTimeStrings) { keywords[n++] = kw; }
+		for (const char *kw : FilamentStrings) { keywords[n++] = kw; }
+		keywords[n++] = SimulatedTimeString;
+
+		// Chain together the keywords that start with the same character. Build the chains in reverse order so that each one is in table order.
+		for (uint8_t& k : firstKeyword)
+		{
+			k = NoKeyword;
+		}
+		for (size_t i = NumKeywords; i != 0; )
+		{
+			--i;
+			const uint8_t c = (uint8_t)keywords[i][0];
+			nextKeyword[i] = firstKeyword[c];
+			firstKeyword[c] = (uint8_t)i;
+		}
+	}
+};
+
+const FileInfoParser::KeywordTables FileInfoParser::keywordTables;
+
+// Scan a null-terminated buffer once for all the keywords, recording where each one first occurs.
+// This replaces a separate search of the whole buffer for each keyword. Most of a G-code file is moves that contain none of the keywords,
+// so in most buffers we find nothing and the Find functions return immediately.
+void FileInfoParser::ScanKeywords(const char *bufp, size_t len) noexcept
+{
+	scannedBuffer = bufp;
+	for (const char *& pos : keywordPos)
+	{
+		pos = nullptr;
+	}
+
+	const char * const end = bufp + len;
+	for (const char *p = bufp; p < end; ++p)
+	{
+		const uint8_t c = (uint8_t)*p;
+		if (c == 0)
+		{
+			break;													// stop where strstr would stop
+		}
+		if (c < ARRAY_SIZE(keywordTables.firstKeyword))
+		{
+			for (uint8_t k = keywordTables.firstKeyword[c]; k != NoKeyword; k = keywordTables.nextKeyword[k])
+			{
+				if (keywordPos[k] == nullptr && StringStartsWith(p, keywordTables.keywords[k]))
+				{
+					keywordPos[k] = p;
+				}
+			}
+		}
+	}
+}
+
+// Return the position of the first occurrence of the keyword in the buffer we last scanned, or nullptr if it doesn't occur
+const char *FileInfoParser::FindKeyword(const char *keyword) const noexcept
+{
+	for (size_t i = 0; i < NumKeywords; ++i)
+	{
+		if (keywordTables.keywords[i] == keyword)
+		{
+			return keywordPos[i];
+		}
+	}
+	return strstr(scannedBuffer, keyword);							// not a keyword we know about, so search for it the slow way
+}
+
 // Scan the buffer for a G1 Zxxx command. The buffer is null-terminated.
 bool FileInfoParser::FindFirstLayerHeight(const char* bufp, size_t len) noexcept
 {
@@ -531,30 +764,18 @@ bool FileInfoParser::FindHeight(const char* bufp, size_t len) noexcept
 // Scan the buffer for the layer height. The buffer is null-terminated.
 bool FileInfoParser::FindLayerHeight(const char *bufp) noexcept
 {
-	static const char* const layerHeightStrings[] =
-	{
-		"layer_height",			// slic3r
-		"Layer height",			// Cura
-		"layerHeight",			// S3D
-		"layer_thickness_mm",	// Kisslicer
-		"layerThickness",		// Matter Control
-		"sliceHeight"			// kiri:moto
-	};
-
 	if (*bufp != 0)
 	{
 		++bufp;														// make sure we can look back 1 character after we find a match
-		for (const char * lhStr : layerHeightStrings)				// search for each string in turn
+		for (const char * lhStr : LayerHeightStrings)				// search for each string in turn
 		{
-			const char *pos = bufp;
-			for(;;)													// loop until success or strstr returns null
+			const char *pos = FindKeyword(lhStr);
+			if (pos != nullptr && pos < bufp)
+			{
+				pos = strstr(bufp, lhStr);							// a match at the very start is no use because we can't look back from it
+			}
+			for (; pos != nullptr; pos = strstr(pos, lhStr))		// loop until success or we run out of matches
 			{
-				pos = strstr(pos, lhStr);
-				if (pos == nullptr)
-				{
-					break;											// didn't find this string in the buffer, so try the next string
-				}
-
 				const char c = pos[-1];								// fetch the previous character
 				pos += strlen(lhStr);								// skip the string we matched
 				if (c == ' ' || c == ';' || c == '\t')				// check we are not in the middle of a word
@@ -578,26 +799,13 @@ bool FileInfoParser::FindLayerHeight(const char *bufp) noexcept
 	return false;
 }
 
-bool FileInfoParser::FindSlicerInfo(const char* bufp) noexcept
+bool FileInfoParser::FindSlicerInfo() noexcept
 {
-	static const char * const GeneratedByStrings[] =
-	{
-		"; KISSlicer",		// KISSlicer
-		";Sliced at: ",		// Cura (old)
-		";Fusion version:",	// Fusion 360
-		"generated by ",	// slic3r and S3D
-		";Sliced by ",		// ideaMaker
-		";Generated with ",	// Cura (new)
-		"; Generated by ",	// kiri:moto
-		";GENERATOR.NAME:",	// Pathio (the version is separate, we don't include that)
-		"; Generated with "	// Matter Control
-	};
-
 	size_t index = 0;
 	const char* pos;
 	do
 	{
-		pos = strstr(bufp, GeneratedByStrings[index]);
+		pos = FindKeyword(GeneratedByStrings[index]);
 		if (pos != nullptr)
 		{
 			break;
@@ -639,10 +847,10 @@ bool FileInfoParser::FindSlicerInfo(const char* bufp) noexcept
 }
 
 // Scan the buffer for a 2-part filament used string. Return the number of filament found.
-void FileInfoParser::FindFilamentUsedEmbedded(const char* p, const char *s1, const char *s2, unsigned int &filamentsFound) noexcept
+void FileInfoParser::FindFilamentUsedEmbedded(const char *s1, const char *s2, unsigned int &filamentsFound) noexcept
 {
 	const size_t maxFilaments = reprap.GetGCodes().GetNumExtruders();
-	while (filamentsFound < maxFilaments &&	(p = strstr(p, s1)) != nullptr)
+	for (const char *p = FindKeyword(s1); filamentsFound < maxFilaments && p != nullptr; p = strstr(p, s1))
 	{
 		p += strlen(s1);
 		const char *q1, *q2;
@@ -667,19 +875,17 @@ void FileInfoParser::FindFilamentUsedEmbedded(const char* p, const char *s1, con
 	}
 }
 
-// Scan the buffer for the filament used. The buffer is null-terminated.
+// Scan the buffer for the filament used. The buffer must have been scanned for keywords.
 // Returns the number of filaments found.
-unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
+unsigned int FileInfoParser::FindFilamentUsed() noexcept
 {
 	unsigned int filamentsFound = 0;
 	const size_t maxFilaments = reprap.GetGCodes().GetNumExtruders();
 
 	// Look for filament usage as generated by Slic3r and Cura
-	const char* const filamentUsedStr1 = "ilament used";			// comment string used by slic3r and Cura, followed by filament used and "mm"
-	const char* p = bufp;
-	while (filamentsFound < maxFilaments &&	(p = strstr(p, filamentUsedStr1)) != nullptr)
+	for (const char *p = FindKeyword(FilamentUsedString); filamentsFound < maxFilaments && p != nullptr; p = strstr(p, FilamentUsedString))
 	{
-		p += strlen(filamentUsedStr1);
+		p += strlen(FilamentUsedString);
 		while(strchr(" [m]:=\t", *p) != nullptr)					// Prusa slicer now uses "; filament used [mm] = 4235.9"
 		{
 			++p;	// this allows for " = " from default slic3r comment and ": " from default Cura comment
@@ -714,20 +920,18 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	}
 
 	// Look for filament usage strings generated by Ideamaker, e.g. ";Material#1 Used: 868.0"
-	FindFilamentUsedEmbedded(bufp, ";Material#", " Used", filamentsFound);
+	FindFilamentUsedEmbedded(IdeamakerFilamentString, " Used", filamentsFound);
 
 	// Look for filament usage strings generated by Fusion 360, e.g. ";Extruder 1 material used: 1811mm"
-	FindFilamentUsedEmbedded(bufp, ";Extruder ", " material used", filamentsFound);
+	FindFilamentUsedEmbedded(FusionFilamentString, " material used", filamentsFound);
 
 
 	// Look for filament usage as generated by S3D
 	if (filamentsFound == 0)
 	{
-		const char *filamentLengthStr = "ilament length";	// comment string used by S3D
-		p = bufp;
-		while (filamentsFound < maxFilaments &&	(p = strstr(p, filamentLengthStr)) != nullptr)
+		for (const char *p = FindKeyword(S3DFilamentString); filamentsFound < maxFilaments && p != nullptr; p = strstr(p, S3DFilamentString))
 		{
-			p += strlen(filamentLengthStr);
+			p += strlen(S3DFilamentString);
 			while(strchr(" :=\t", *p) != nullptr)
 			{
 				++p;
@@ -747,11 +951,9 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	// Look for filament usage as generated by recent KISSlicer versions
 	if (filamentsFound == 0)
 	{
-		const char *filamentLengthStr = ";    Ext ";
-		p = bufp;
-		while (filamentsFound < maxFilaments && (p = strstr(p, filamentLengthStr)) != nullptr)
+		for (const char *p = FindKeyword(KISSlicerFilamentString); filamentsFound < maxFilaments && p != nullptr; p = strstr(p, KISSlicerFilamentString))
 		{
-			p += strlen(filamentLengthStr);
+			p += strlen(KISSlicerFilamentString);
 			if (*p == '#')
 			{
 				++p;				// later KISSlicer versions add a # here
@@ -780,14 +982,14 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	// Special case: Old KISSlicer and Pathio only generate the filament volume, so we need to calculate the length from it
 	if (filamentsFound == 0 && reprap.GetPlatform().GetFilamentWidth() > 0.0)
 	{
-		const char *filamentVolumeStr = "; Estimated Build Volume: ";				// old KISSlicer
+		const char *filamentVolumeStr = KISSlicerVolumeString;
 		float multipler = 1000.0;													// volume is in cm^3
-		p = strstr(bufp, filamentVolumeStr);
+		const char *p = FindKeyword(filamentVolumeStr);
 		if (p == nullptr)
 		{
-			filamentVolumeStr = ";EXTRUDER_TRAIN.0.MATERIAL.VOLUME_USED:";			// Pathio
+			filamentVolumeStr = PathioVolumeString;
 			multipler = 1.0;														// volume is in mm^3
-			p = strstr(bufp, filamentVolumeStr);
+			p = FindKeyword(filamentVolumeStr);
 		}
 		if (p != nullptr)
 		{
@@ -803,26 +1005,11 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 }
 
 // Scan the buffer for the estimated print time
-bool FileInfoParser::FindPrintTime(const char* bufp) noexcept
+bool FileInfoParser::FindPrintTime() noexcept
 {
-	static const char* const PrintTimeStrings[] =
-	{
-		// Note: if a string in this table is a leading or embedded substring of another, the longer one must come first
-		" estimated printing time (normal mode)",	// slic3r PE later versions	"; estimated printing time (normal mode) = 1h 5m 24s"
-		" estimated printing time",					// slic3r PE older versions	"; estimated printing time = 1h 5m 24s"
-		";TIME",									// Cura						";TIME:38846"
-		" Build time",								// S3D						";   Build time: 0 hours 42 minutes"
-		" Build Time",								// KISSlicer				"; Estimated Build Time:   332.83 minutes"
-													// also KISSSlicer 2 alpha	"; Calculated-during-export Build Time: 130.62 minutes"
-		";Print Time:",								// Ideamaker
-		";PRINT.TIME:",								// Patio
-		";Print time:",								// Fusion 360
-		"; total print time (s) ="					// Matter Control
-	};
-
 	for (const char * ptStr : PrintTimeStrings)
 	{
-		const char* pos = strstr(bufp, ptStr);
+		const char* pos = FindKeyword(ptStr);
 		if (pos != nullptr)
 		{
 			pos += strlen(ptStr);
@@ -890,9 +1077,9 @@ bool FileInfoParser::FindPrintTime(const char* bufp) noexcept
 }
 
 // Scan the buffer for the simulated print time
-bool FileInfoParser::FindSimulatedTime(const char* bufp) noexcept
+bool FileInfoParser::FindSimulatedTime() noexcept
 {
-	const char* pos = strstr(bufp, SimulatedTimeString);
+	const char* pos = FindKeyword(SimulatedTimeString);
 	if (pos != nullptr)
 	{
 		pos += strlen(SimulatedTimeString);
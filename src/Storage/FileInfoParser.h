@@ -28,6 +28,14 @@ const size_t GcodeFooterPrintTimeSearchSize = 4096;	// How much of the end of th
 
 const size_t GCODE_OVERLAP_SIZE = 100;				// Size of the overlapping buffer for searching (must be a multiple of 4)
 
+#if SAME70 || SAME5x
+const size_t NumFileInfoCacheEntries = 32;			// How many parsed file info results we remember
+#elif LPC17xx
+const size_t NumFileInfoCacheEntries = 4;
+#else
+const size_t NumFileInfoCacheEntries = 16;
+#endif
+
 const uint32_t MAX_FILEINFO_PROCESS_TIME = 200;		// Maximum time to spend polling for file info in each call
 const uint32_t MaxFileParseInterval = 4000;			// Maximum interval between repeat requests to parse a file
 
@@ -47,19 +55,45 @@ public:
 	// The following method needs to be called repeatedly until it doesn't return GCodeResult::notFinished - this may take a few runs
 	GCodeResult GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept;
 
+	// Forget all cached file information. Call this when a file is modified without changing its size or last modified time.
+	void InvalidateCache() noexcept;
+
+	void GetAndClearCacheStats(unsigned int& hits, unsigned int& misses) noexcept;
+
 	static constexpr const char* SimulatedTimeString = "\n; Simulated print time";	// used by FileInfoParser and MassStorage
 
 private:
+	// Entry in the cache of parsed file info. The entry matches a file if the path, size and last modified time are all the same.
+	struct FileInfoCacheEntry
+	{
+		uint32_t pathHash;							// CRC32 of the path with letters folded to lower case
+		uint32_t lastUsed;							// when we last returned this entry, so that we can replace the least recently used one
+		GCodeFileInfo info;							// the parsed information, including the file size and last modified time; isValid is false if the entry is unused
+	};
+
+	static uint32_t HashPath(const char *filePath) noexcept;
+	bool FindCachedInfo(const char *filePath, GCodeFileInfo& info) noexcept;
+	void AddCachedInfo(const char *filePath, const GCodeFileInfo& info) noexcept;
 
 	// G-Code parser methods
 	bool FindHeight(const char* bufp, size_t len) noexcept;
 	bool FindFirstLayerHeight(const char* bufp, size_t len) noexcept;
 	bool FindLayerHeight(const char* bufp) noexcept;
-	bool FindSlicerInfo(const char* bufp) noexcept;
-	bool FindPrintTime(const char* bufp) noexcept;
-	bool FindSimulatedTime(const char* bufp) noexcept;
-	unsigned int FindFilamentUsed(const char* bufp) noexcept;
-	void FindFilamentUsedEmbedded(const char* p, const char *s1, const char *s2, unsigned int &filamentsFound) noexcept;
+	bool FindSlicerInfo() noexcept;
+	bool FindPrintTime() noexcept;
+	bool FindSimulatedTime() noexcept;
+	unsigned int FindFilamentUsed() noexcept;
+	void FindFilamentUsedEmbedded(const char *s1, const char *s2, unsigned int &filamentsFound) noexcept;
+
+	// Keyword scanner. We scan each buffer once for all the strings that the Find functions look for and record where each one first occurs.
+	static constexpr size_t NumKeywords = 32;
+	static constexpr uint8_t NoKeyword = 0xFF;
+
+	struct KeywordTables;
+	static const KeywordTables keywordTables;		// the strings we look for and the chains the scanner follows, built at compile time
+
+	void ScanKeywords(const char *bufp, size_t len) noexcept;
+	const char *FindKeyword(const char *keyword) const noexcept;
 
 	// We parse G-Code files in multiple stages. These variables hold the required information
 	Mutex parserMutex;
@@ -73,6 +107,14 @@ private:
 	uint32_t accumulatedParseTime, accumulatedReadTime, accumulatedSeekTime;
 	size_t fileOverlapLength;
 
+	const char *keywordPos[NumKeywords];			// where each one first occurs in the buffer we last scanned, or nullptr
+	const char *scannedBuffer;						// the buffer we last scanned
+
+	// Cache of results, so that we can answer repeated requests without accessing the file or waiting for the parser
+	Mutex cacheMutex;
+	FileInfoCacheEntry cache[NumFileInfoCacheEntries];
+	unsigned int cacheHits, cacheMisses;
+
 	// We used to allocate the following buffer on the stack; but now that this is called by more than one task
 	// it is more economical to allocate it permanently because that lets us use smaller stacks.
 	// Alternatively, we could allocate a FileBuffer temporarily.
@@ -23,6 +23,10 @@
 #endif
 
 
+#if HAS_MASS_STORAGE
+uint32_t FileStore::directWrites = 0;
+#endif
+
 FileStore::FileStore() noexcept
 	:
 #if HAS_MASS_STORAGE
@@ -129,16 +133,16 @@ bool FileStore::Open(const char* filePath, OpenMode mode, uint32_t preAllocSize)
 		calcCrc = (mode == OpenMode::writeWithCrc);
 		usageMode = (writing) ? FileUseMode::readWrite : FileUseMode::readOnly;
 		openCount = 1;
-# if LPC17xx || STM32F4
 		if (preAllocSize != 0 && (mode == OpenMode::write || mode == OpenMode::writeWithCrc))
 		{
-			const FRESULT expandReturn = f_expand(&file, preAllocSize, 1);		// try to pre-allocate contiguous space - it doesn't matter if it fails
+			// Try to pre-allocate contiguous space - it doesn't matter if it fails.
+			// Contiguous clusters let FatFS write large blocks of sectors without updating the FAT chain as the file grows.
+			const FRESULT expandReturn = f_expand(&file, preAllocSize, 1);
 			if (reprap.Debug(moduleStorage))
 			{
 				debugPrintf("Preallocating %" PRIu32 " bytes returned %d\n", preAllocSize, (int)expandReturn);
 			}
 		}
-# endif
 		reprap.VolumesUpdated();
 		return true;
 	}
@@ -501,7 +505,19 @@ bool FileStore::Write(const char *s, size_t len) noexcept
 			}
 			else
 			{
-				do
+				// If we can write whole sectors straight from the caller's data, do that instead of copying it to the write buffer first.
+				// FatFS passes them to the card as a single multi-sector write.
+				const size_t directWriteLength = GetDirectWriteLength(s, len);
+				if (directWriteLength != 0)
+				{
+					writeStatus = Store(s, directWriteLength, &totalBytesWritten);
+					if (writeStatus == FR_OK && totalBytesWritten == directWriteLength)
+					{
+						++directWrites;
+					}
+				}
+
+				while (writeStatus == FR_OK && totalBytesWritten != len)
 				{
 #if HAS_WRITER_TASK
 					// If the buffer is currently being written we need to wait for it to complete
@@ -528,7 +544,6 @@ bool FileStore::Write(const char *s, size_t len) noexcept
 					}
 					totalBytesWritten += bytesStored;
 				}
-				while (writeStatus == FR_OK && totalBytesWritten != len);
 			}
 
 			if ((writeStatus != FR_OK) || (totalBytesWritten != len))
@@ -545,12 +560,45 @@ bool FileStore::Write(const char *s, size_t len) noexcept
 	}
 }
 
+// Return how many bytes at the start of the data we can write directly to the file, bypassing the write buffer.
+// We only do this when the write buffer is empty and the file position is at a sector boundary, so that FatFS can write whole sectors
+// from the caller's data without going through its sector window. We don't do it when the data would fit in the write buffer,
+// because then the write to the card would be smaller than if we had buffered the data.
+size_t FileStore::GetDirectWriteLength(const char *s, size_t len) const noexcept
+{
+	const size_t alignedLength = len & ~(FF_MAX_SS - 1);
+	if (   alignedLength >= FileWriteBufLen
+		&& writeBuffer->BytesStored() == 0
+#if HAS_WRITER_TASK
+		&& writeBuffer != bufferToWrite
+#endif
+		&& ((uint32_t)s & 3) == 0							// the SD card drivers need word-aligned data for DMA
+		&& (f_tell(&file) & (FF_MAX_SS - 1)) == 0
+	   )
+	{
+		return alignedLength;
+	}
+	return 0;
+}
+
+// Return the number of writes made directly from callers' data since the last call, and clear it
+/*static*/ uint32_t FileStore::GetAndClearDirectWrites() noexcept
+{
+	const uint32_t ret = directWrites;
+	directWrites = 0;
+	return ret;
+}
+
+// Return how much data the caller can write without waiting for the write buffer to be written.
+// When the write buffer is empty we accept any amount, so that uploads can hand over whole network chunks even when the buffer is small.
+// Whole sectors of the data are then written directly if the file position and the data are suitably aligned, and the remainder fits in
+// the buffer. Otherwise the data is buffered, which only means waiting for a card write if there is more of it than the buffer holds.
 int FileStore::CanWrite() noexcept
 {
 #if HAS_WRITER_TASK
-	return writeBuffer == nullptr ? 0x7fffffff : writeBuffer == bufferToWrite ? 0 : writeBuffer->BytesLeft();
+	return writeBuffer == nullptr ? 0x7fffffff : writeBuffer == bufferToWrite ? 0 : writeBuffer->BytesStored() == 0 ? 0x7fffffff : writeBuffer->BytesLeft();
 #else
-	return writeBuffer == nullptr ? 0x7fffffff : writeBuffer->BytesLeft();
+	return writeBuffer == nullptr || writeBuffer->BytesStored() == 0 ? 0x7fffffff : writeBuffer->BytesLeft();
 #endif
 }
 
@@ -51,6 +51,7 @@ public:
 	bool Write(const uint8_t *s, size_t len) noexcept;			// Write a block of len bytes
 	bool Write(const char* s) noexcept;							// Write a string
 	int CanWrite() noexcept;
+	static uint32_t GetAndClearDirectWrites() noexcept;
 #endif
 	bool Close() noexcept;										// Shut the file and tidy up
 #if HAS_MASS_STORAGE
@@ -95,6 +96,7 @@ private:
 #endif
 #if HAS_MASS_STORAGE
 	FRESULT Store(const char *s, size_t len, size_t *bytesWritten) noexcept; // Write data to the non-volatile storage
+	size_t GetDirectWriteLength(const char *s, size_t len) const noexcept;
 
     FIL file;
 	FileWriteBuffer *writeBuffer;
@@ -110,6 +112,7 @@ private:
 	CRC32 crc;
 
 	static uint32_t longestWriteTime;
+	static uint32_t directWrites;								// number of writes that bypassed the write buffer
 #endif
 #if HAS_LINUX_INTERFACE
 	char* absoluteFilename;
@@ -174,7 +174,7 @@ static FileStore files[MAX_FILES];
 // Sequence number management
 uint16_t MassStorage::GetVolumeSeq(unsigned int volume) noexcept
 {
-	return info[volume].seq;
+	return (volume < NumSdCards) ? info[volume].seq : 0;
 }
 
 // If 'path' is not the name of a temporary file, update the sequence number of its volume
@@ -710,6 +710,18 @@ time_t MassStorage::GetLastModifiedTime(const char *filePath) noexcept
 	return 0;
 }
 
+bool MassStorage::GetFileSizeAndTime(const char *filePath, FilePosition& size, time_t& lastModified) noexcept
+{
+	FILINFO fil;
+	if (f_stat(filePath, &fil) == FR_OK && (fil.fattrib & AM_DIR) == 0)
+	{
+		size = fil.fsize;
+		lastModified = ConvertTimeStamp(fil.fdate, fil.ftime);
+		return true;
+	}
+	return false;
+}
+
 bool MassStorage::SetLastModifiedTime(const char *filePath, time_t time) noexcept
 {
 	tm timeInfo;
@@ -1015,6 +1027,9 @@ void MassStorage::RecordSimulationTime(const char *printingFilePath, uint32_t si
 		{
 			ok = SetLastModifiedTime(printingFilePath, lastModtime);
 		}
+
+		// We may have changed the file without changing its size, and we restored the last modified time, so any cached info for it may be out of date
+		infoParser.InvalidateCache();
 	}
 
 	if (!ok)
@@ -1088,8 +1103,18 @@ void MassStorage::Diagnostics(MessageType mtype) noexcept
 # endif
 
 	// Show the longest SD card write time
-	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u\n",
-								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount());
+	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u, unbuffered writes %" PRIu32 "\n",
+								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount(),
+								FileStore::GetAndClearDirectWrites());
+#if SD_READ_CACHE_LINES
+	uint32_t cacheHits, cacheMisses;
+	DiskioGetAndClearCacheStats(cacheHits, cacheMisses);
+	platform.MessageF(mtype, "SD card read cache hits %" PRIu32 ", misses %" PRIu32 "\n", cacheHits, cacheMisses);
+#endif
+
+	unsigned int fileInfoHits, fileInfoMisses;
+	infoParser.GetAndClearCacheStats(fileInfoHits, fileInfoMisses);
+	platform.MessageF(mtype, "File info cache hits %u, misses %u\n", fileInfoHits, fileInfoMisses);
 }
 
 # if SUPPORT_OBJECT_MODEL
@@ -46,6 +46,7 @@ namespace MassStorage
 	bool DirectoryExists(const StringRef& path) noexcept;									// Warning: if 'path' has a trailing '/' or '\\' character, it will be removed!
 	bool DirectoryExists(const char *path) noexcept;
 	time_t GetLastModifiedTime(const char *filePath) noexcept;
+	bool GetFileSizeAndTime(const char *filePath, FilePosition& size, time_t& lastModified) noexcept;	// returns false if the file doesn't exist or is a directory
 	bool SetLastModifiedTime(const char *file, time_t time) noexcept;
 	GCodeResult Mount(size_t card, const StringRef& reply, bool reportSuccess) noexcept;
 	GCodeResult Unmount(size_t card, const StringRef& reply) noexcept;
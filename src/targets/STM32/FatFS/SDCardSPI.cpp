@@ -59,6 +59,10 @@ constexpr uint32_t SCLK_INIT =  400000;     /* SCLK frequency under initializati
 
 #define SD_COMMAND_TIMEOUT 5000
 
+// The card can stay busy for hundreds of milliseconds after a write or while it prepares data for a read.
+// Most waits are much shorter than that, so we poll at full speed for this long and then sleep between polls, letting other tasks run.
+constexpr uint32_t SdFastPollMillis = 2;
+
 SDCardSPI::SDCardSPI(SSPChannel SSPSlot, Pin cs) noexcept {
     
     maxFrequency = SCLK_SD12; //default max frequency to run at
@@ -150,9 +154,10 @@ int SDCardSPI::wait_ready (uint32_t wt)  noexcept/* 1:Ready, 0:Timeout */
     
     do {
         d = xchg_spi(0xFF);
-        
-        /* This loop takes a time. Insert rot_rdq() here for multitask envilonment. */
-        
+        if (d != 0xFF && millis() - now >= SdFastPollMillis)
+        {
+            delay(1);                           /* Let other tasks run while the card is busy */
+        }
     } while (d != 0xFF && (millis() - now) < wt);    /* Wait for card goes ready or timeout */
     
     return (d == 0xFF) ? 1 : 0;
@@ -218,9 +223,10 @@ int SDCardSPI::rcvr_datablock (uint8_t *buff, uint32_t btr) noexcept/* 1:OK, 0:E
     uint32_t now = millis();
     do {                            /* Wait for DataStart token in timeout of 200ms */
         token = xchg_spi(0xFF);
-        
-        /* This loop will take a time. Insert rot_rdq() here for multitask envilonment. */
-        
+        if (token != 0xFE && millis() - now >= SdFastPollMillis)
+        {
+            delay(1);                   /* Let other tasks run while the card fetches the data */
+        }
     } while ((token != 0xFE) && (millis() - now) < 200 );
     if(token != 0xFE) return 0;        /* Function fails if invalid DataStart token or timeout */
     // FIXME SPI should really provide dummy data
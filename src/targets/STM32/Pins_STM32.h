@@ -40,6 +40,8 @@
 #define SUPPORT_OBJECT_MODEL             1
 #define HAS_CPU_TEMP_SENSOR		         1	// enabling the CPU temperature sensor disables Due pin 13 due to bug in SAM3X
 #define HAS_HIGH_SPEED_SD		         0
+#define SD_READ_CACHE_LINES              4	// number of lines in the SD card read-ahead cache, or 0 for no cache
+#define SD_READ_CACHE_SECTORS_PER_LINE   4	// number of sectors read ahead into each line
 #define HAS_VOLTAGE_MONITOR		         1
 #define ACTIVE_LOW_HEAT_ON		         0
 #define HAS_VREF_MONITOR                 0
@@ -28,6 +28,52 @@ static unsigned int highestSdRetriesDone = 0;
 static uint32_t longestWriteTime = 0;
 static uint32_t longestReadTime = 0;
 
+// Read-ahead sector cache.
+// FatFS reads files through its one-sector window, so reading a file sequentially in small chunks produces a stream of single-sector reads.
+// On SPI cards each of those is a separate CMD17 with its own command overhead. When we see sequential single-sector reads we instead read
+// a whole cache line of sectors with one CMD18 and serve the following reads from it. Only the data is cached; writes go straight to the card
+// and discard any cached copies of the sectors written. The cache size is set in the pins file for each target.
+#if SD_READ_CACHE_LINES
+constexpr size_t DiskCacheLines = SD_READ_CACHE_LINES;						// number of cache lines per drive
+constexpr size_t DiskCacheSectorsPerLine = SD_READ_CACHE_SECTORS_PER_LINE;	// number of sectors we read ahead in one go
+constexpr size_t NumCachedDrives = 1;					// we only cache the internal card, which is where files are normally printed from
+constexpr size_t DiskSectorSize = 512;
+
+struct DiskCacheLine
+{
+	alignas(4) BYTE data[DiskCacheSectorsPerLine * DiskSectorSize];	// 32-bit aligned so that it can be used for DMA
+	DWORD firstSector;
+	uint32_t lastUsed;
+	bool valid;
+};
+
+static DiskCacheLine diskCache[NumCachedDrives][DiskCacheLines];
+static DWORD lastSectorRead[NumCachedDrives];
+static uint32_t diskCacheHits = 0, diskCacheMisses = 0;
+
+void DiskioGetAndClearCacheStats(uint32_t& hits, uint32_t& misses) noexcept
+{
+	hits = diskCacheHits;
+	misses = diskCacheMisses;
+	diskCacheHits = diskCacheMisses = 0;
+}
+
+static void InvalidateDiskCache(BYTE drv, DWORD sector, DWORD count) noexcept
+{
+	if (drv < NumCachedDrives)
+	{
+		for (DiskCacheLine& line : diskCache[drv])
+		{
+			if (line.valid && sector < line.firstSector + DiskCacheSectorsPerLine && line.firstSector < sector + count)
+			{
+				line.valid = false;
+			}
+		}
+	}
+}
+
+#endif
+
 unsigned int DiskioGetAndClearMaxRetryCount() noexcept
 {
     const unsigned int ret = highestSdRetriesDone;
@@ -53,6 +99,9 @@ float DiskioGetAndClearLongestWriteTime() noexcept
 /* drv - Physical drive nmuber (0..) */
 DSTATUS disk_initialize (BYTE drv) noexcept
 {
+#if SD_READ_CACHE_LINES
+	InvalidateDiskCache(drv, 0, 0xFFFFFFFF);			// the card may have been changed
+#endif
 	return (DSTATUS)_ffs[drv]->disk_initialize();
 }
 
@@ -62,15 +111,12 @@ DSTATUS disk_status (BYTE drv) noexcept
 	return (DSTATUS)_ffs[drv]->disk_status();
 }
 
-/* drv - Physical drive nmuber (0..) */
-/* buff - Data buffer to store read data */
-/* sector - Sector address (LBA) */
-/* count - Number of sectors to read (1..255) */
-DRESULT disk_read (BYTE drv, BYTE *buff, DWORD sector, BYTE count) noexcept
+// Read sectors from the card, retrying if necessary
+static DRESULT ReadSectors(BYTE drv, BYTE *buff, DWORD sector, DWORD count) noexcept
 {
     if (reprap.Debug(moduleStorage))
     {
-        debugPrintf("Read %u %u %lu\n", drv, count, sector);
+        debugPrintf("Read %u %lu %lu\n", drv, count, sector);
     }
     
     unsigned int retryNumber = 0;
@@ -110,6 +156,60 @@ DRESULT disk_read (BYTE drv, BYTE *buff, DWORD sector, BYTE count) noexcept
     return RES_OK;
 }
 
+/* drv - Physical drive nmuber (0..) */
+/* buff - Data buffer to store read data */
+/* sector - Sector address (LBA) */
+/* count - Number of sectors to read (1..255) */
+DRESULT disk_read (BYTE drv, BYTE *buff, DWORD sector, BYTE count) noexcept
+{
+#if SD_READ_CACHE_LINES
+	if (drv >= NumCachedDrives || count >= DiskCacheSectorsPerLine)
+	{
+		return ReadSectors(drv, buff, sector, count);		// FatFS is already reading a large block, so we can't improve on it
+	}
+
+	// See if we have all the sectors in the cache
+	const uint32_t now = millis();
+	DiskCacheLine *victim = &diskCache[drv][0];
+	for (DiskCacheLine& line : diskCache[drv])
+	{
+		if (line.valid && sector >= line.firstSector && sector + count <= line.firstSector + DiskCacheSectorsPerLine)
+		{
+			memcpy(buff, line.data + (sector - line.firstSector) * DiskSectorSize, count * DiskSectorSize);
+			line.lastUsed = now;
+			lastSectorRead[drv] = sector + count - 1;
+			++diskCacheHits;
+			return RES_OK;
+		}
+		if (victim->valid && (!line.valid || now - line.lastUsed > now - victim->lastUsed))
+		{
+			victim = &line;
+		}
+	}
+
+	++diskCacheMisses;
+	const bool sequential = (sector == lastSectorRead[drv] + 1);
+	lastSectorRead[drv] = sector + count - 1;
+
+	// If this read follows on from the last one then the file is probably being read sequentially, so read ahead into the least recently used line.
+	// Don't read past the end of the card.
+	const DWORD numSectors = _ffs[drv]->disk_sectors();
+	if (sequential && sector + DiskCacheSectorsPerLine <= numSectors)
+	{
+		victim->valid = false;
+		if (ReadSectors(drv, victim->data, sector, DiskCacheSectorsPerLine) == RES_OK)
+		{
+			victim->firstSector = sector;
+			victim->lastUsed = now;
+			victim->valid = true;
+			memcpy(buff, victim->data, count * DiskSectorSize);
+			return RES_OK;
+		}
+	}
+#endif
+	return ReadSectors(drv, buff, sector, count);
+}
+
 #if _READONLY == 0
 /* drv - Physical drive nmuber (0..) */
 /* buff - Data to be written */
@@ -122,6 +222,10 @@ DRESULT disk_write (BYTE drv, const BYTE *buff, DWORD sector, BYTE count) noexce
     {
         debugPrintf("Write %u %u %lu\n", drv, count, sector);
     }
+
+#if SD_READ_CACHE_LINES
+    InvalidateDiskCache(drv, sector, count);
+#endif
     
     /* Write the data */
     unsigned int retryNumber = 0;